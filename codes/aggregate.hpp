@@ -0,0 +1,91 @@
+#pragma once
+
+// Aggregate reflection from "Printing Aggregates", as a header:
+// field_count<T>(), tie_as_tuple(x) and type_name<T>().
+
+#include <cstddef>
+#include <source_location>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace aggregate_detail {
+
+struct any_type {
+    template <class T>
+    operator T() const;
+};
+
+} // namespace aggregate_detail
+
+template <class T>
+    requires std::is_aggregate_v<T>
+consteval std::size_t field_count(auto... args) {
+    if constexpr (!requires { T{args...}; }) {
+        return sizeof...(args) - 1;
+    } else {
+        return field_count<T>(args..., aggregate_detail::any_type{});
+    }
+}
+
+/// A tuple of references to the fields of `x`; const if `x` is
+template <class T>
+constexpr auto tie_as_tuple(T& x) {
+    constexpr auto N = field_count<std::remove_cv_t<T>>();
+    if constexpr (N == 0) {
+        return std::tie();
+    } else if constexpr (N == 1) {
+        auto& [_0] = x;
+        return std::tie(_0);
+    } else if constexpr (N == 2) {
+        auto& [_0, _1] = x;
+        return std::tie(_0, _1);
+    } else if constexpr (N == 3) {
+        auto& [_0, _1, _2] = x;
+        return std::tie(_0, _1, _2);
+    } else if constexpr (N == 4) {
+        auto& [_0, _1, _2, _3] = x;
+        return std::tie(_0, _1, _2, _3);
+    } else if constexpr (N == 5) {
+        auto& [_0, _1, _2, _3, _4] = x;
+        return std::tie(_0, _1, _2, _3, _4);
+    } else if constexpr (N == 6) {
+        auto& [_0, _1, _2, _3, _4, _5] = x;
+        return std::tie(_0, _1, _2, _3, _4, _5);
+    } else if constexpr (N == 7) {
+        auto& [_0, _1, _2, _3, _4, _5, _6] = x;
+        return std::tie(_0, _1, _2, _3, _4, _5, _6);
+    } else if constexpr (N == 8) {
+        auto& [_0, _1, _2, _3, _4, _5, _6, _7] = x;
+        return std::tie(_0, _1, _2, _3, _4, _5, _6, _7);
+    } else {
+        static_assert(sizeof(T) != sizeof(T), "Too many fields");
+    }
+}
+
+namespace aggregate_detail {
+
+template <class Tuple>
+struct decay_fields;
+
+template <class... F>
+struct decay_fields<std::tuple<F...>> {
+    using type = std::tuple<std::remove_cvref_t<F>...>;
+};
+
+} // namespace aggregate_detail
+
+/// The fields' types, without references: std::tuple<int, int> for Point
+template <class T>
+using fields_t = typename aggregate_detail::decay_fields<
+    decltype(tie_as_tuple(std::declval<T&>()))>::type;
+
+/// "Point" for Point; "ns::Point" in a namespace. Implementation-defined
+/// text, as function_name() is, but GCC and Clang both spell T = ...
+template <class T>
+consteval std::string_view type_name() {
+    std::string_view s = std::source_location::current().function_name();
+    auto i0 = s.find("T = ") + 4;
+    auto i1 = s.find_first_of(";]", i0);
+    return s.substr(i0, i1 - i0);
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+// A formatter for small numeric aggregates, to derive from:
+//
+//   struct Point { int x, y; };
+//   template <>
+//   struct fmt_lib::formatter<Point> : aggregate_formatter<Point> {};
+//
+//   format("{}", p)     -> "Point(1, 2)"
+//   format("{:+}", p)   -> "Point(+1, +2)": the spec applies to each field
+//
+// Unlike the formatter in "Experience with std::format", which calls
+// format_to(ctx.out(), "Point({}, {})", ...) and so parses that format
+// string on every call:
+// - the spec is parsed once per replacement field, into one formatter per
+//   field, for that field's type, and the fields go straight to them;
+// - with an empty spec (the common case) the whole text is built with
+//   my::to_chars in a stack buffer and appended in one go, not one char
+//   at a time through the output iterator.
+
+#include "aggregate.hpp"
+#include "print.hpp"
+#include "to_chars.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace aggregate_detail {
+
+template <class F>
+inline constexpr bool is_character =
+    std::is_same_v<F, char> || std::is_same_v<F, signed char> ||
+    std::is_same_v<F, unsigned char> || std::is_same_v<F, wchar_t> ||
+    std::is_same_v<F, char8_t> || std::is_same_v<F, char16_t> || std::is_same_v<F, char32_t>;
+
+/// Chars of every kind are numbers here, as with my::to_chars, not
+/// characters: formatter<wchar_t, char> and the like don't exist
+template <class F>
+using as_number =
+    std::conditional_t<is_character<F>, std::conditional_t<std::is_signed_v<F>, int, unsigned>, F>;
+
+template <class Tuple>
+struct numeric_fields;
+
+template <class... F>
+struct numeric_fields<std::tuple<F...>> {
+    static constexpr bool value = (my::formattable_number<F> && ...);
+    static constexpr std::size_t max_chars = (std::size_t{0} + ... + my::max_chars<F>);
+    using formatters = std::tuple<fmt_lib::formatter<as_number<F>, char>...>;
+};
+
+} // namespace aggregate_detail
+
+template <class T>
+    requires aggregate_detail::numeric_fields<fields_t<T>>::value
+struct aggregate_formatter {
+    using fields = aggregate_detail::numeric_fields<fields_t<T>>;
+
+    static constexpr std::string_view name = type_name<T>();
+    static constexpr std::string_view separator = ", ";
+    static constexpr std::size_t n = std::tuple_size_v<fields_t<T>>;
+    static constexpr std::size_t max_chars =
+        name.size() + 2 + fields::max_chars + separator.size() * (n > 0 ? n - 1 : 0);
+
+    /// Each field's formatter parses the same spec, so one with a dynamic
+    /// width or precision ("{:{}}") would take an argument per field
+    constexpr auto parse(auto& ctx) {
+        auto it = ctx.begin();
+        fast_ = it == ctx.end() || *it == '}';
+        if (!fast_) {
+            std::apply([&](auto&... f) { ((it = f.parse(ctx)), ...); }, inner_);
+        }
+        return it;
+    }
+
+    auto format(const T& x, auto& ctx) const {
+        auto fs = tie_as_tuple(x);
+        if (fast_) {
+            std::array<char, max_chars> buf;
+            char* p = append(buf.data(), name);
+            *p++ = '(';
+            std::apply(
+                [&](const auto&... f) {
+                    std::size_t i = 0;
+                    ((p = i++ > 0 ? append(p, separator) : p, p = my::to_chars(p, f)), ...);
+                },
+                fs);
+            *p++ = ')';
+            return write(ctx, {buf.data(), std::size_t(p - buf.data())});
+        }
+        auto out = write(ctx, name);
+        *out++ = '(';
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((out = I > 0 ? std::copy(separator.begin(), separator.end(), out) : out,
+              ctx.advance_to(out),
+              out = format_field(std::get<I>(inner_), std::get<I>(fs), ctx)),
+             ...);
+        }(std::make_index_sequence<n>{});
+        *out++ = ')';
+        return out;
+    }
+
+private:
+    static char* append(char* p, std::string_view s) noexcept {
+        return std::copy(s.begin(), s.end(), p);
+    }
+
+    /// Both libraries append a string_view in bulk (fmt: buffer::append,
+    /// libstdc++: the sink's _M_write), where std::copy would go a char
+    /// at a time through the iterator
+    static auto write(auto& ctx, std::string_view s) {
+        return fmt_lib::formatter<std::string_view, char>{}.format(s, ctx);
+    }
+
+    template <class F>
+    static auto format_field(const auto& formatter, const F& f, auto& ctx) {
+        return formatter.format(aggregate_detail::as_number<F>(f), ctx);
+    }
+
+    typename fields::formatters inner_;
+    bool fast_ = true;
+};
@@ -0,0 +1,277 @@
+#include "raii.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+struct flush_policy {
+    std::size_t every_bytes = 0;          // 0: not by size
+    std::chrono::milliseconds every{0};   // 0: not by time
+    bool data_only = true; // fdatasync instead of msync(MS_SYNC) + fsync
+};
+
+/// An append-only file that is written through a shared mapping.
+///
+/// The whole `max_size` is mapped once, up front, and the file is grown
+/// underneath it with ftruncate. Since the mapping never moves, pointers
+/// from `prepare()` stay valid for the lifetime of the log; with mremap
+/// (MREMAP_MAYMOVE) they would not.
+/// Virtual address space is cheap; pages past the end of file are never touched.
+///
+/// The file is grown ahead of the records, so its size says nothing after
+/// a crash. A header holds the length instead, written by sync() once the
+/// records it covers are durable: reopening finds exactly what was synced.
+class mapped_append_log {
+    struct header {
+        char magic[8];
+        std::uint64_t length; // durable bytes of records
+    };
+    static constexpr char magic[8] = {'a', 'p', 'p', 'e', 'n', 'd', 'l', '1'};
+    static constexpr std::size_t header_size = 64; // records start a cache line in
+
+    unique_fd fd_;
+    mapped_mem_ptr mem_;
+    std::size_t size_{};     // bytes appended
+    std::size_t capacity_{}; // current file size, header included
+    std::size_t synced_{};   // bytes known to be durable
+    flush_policy policy_;
+    std::chrono::steady_clock::time_point last_sync_;
+
+    static constexpr std::size_t min_capacity = 1 << 20;
+
+    std::byte* base() const noexcept {
+        return static_cast<std::byte*>(mem_.get()) + header_size;
+    }
+
+    header* head() const noexcept {
+        return static_cast<header*>(mem_.get());
+    }
+
+    static std::system_error error(const char* what) {
+        return {errno, std::system_category(), what};
+    }
+
+    /// Make the file at least `need` bytes, header included
+    void grow(std::size_t need) {
+        std::size_t cap = std::max(capacity_, min_capacity);
+        while (cap < need) {
+            cap *= 2;
+        }
+        cap = std::min(cap, mem_.get_deleter().length);
+        if (cap < need) {
+            throw std::length_error("mapped_append_log: max_size exceeded");
+        }
+        if (::ftruncate(int(fd_.get()), off_t(cap)) != 0) {
+            throw error("ftruncate");
+        }
+        capacity_ = cap;
+    }
+
+    /// Write back bytes [from, to) of the file, as changed in the mapping
+    void write_back(std::size_t from, std::size_t to) {
+        if (policy_.data_only) {
+            // Mapped pages are page-cache pages, so this writes them back too
+            if (::fdatasync(int(fd_.get())) != 0) {
+                throw error("fdatasync");
+            }
+            return;
+        }
+        static const std::size_t page = std::size_t(::sysconf(_SC_PAGESIZE));
+        std::size_t first = from / page * page;
+        if (::msync(static_cast<std::byte*>(mem_.get()) + first,
+                    to - first, MS_SYNC) != 0) {
+            throw error("msync");
+        }
+        if (::fsync(int(fd_.get())) != 0) { // the file size
+            throw error("fsync");
+        }
+    }
+
+    void maybe_sync() {
+        bool by_size = policy_.every_bytes != 0 &&
+                       size_ - synced_ >= policy_.every_bytes;
+        bool by_time = policy_.every.count() != 0 &&
+                       std::chrono::steady_clock::now() - last_sync_ >= policy_.every;
+        if (by_size || by_time) {
+            sync();
+        }
+    }
+
+public:
+    mapped_append_log(const char* path, std::size_t max_size = std::size_t(64) << 30,
+                      flush_policy policy = {})
+        : fd_(open_fd(path, O_RDWR | O_CREAT)), policy_(policy),
+          last_sync_(std::chrono::steady_clock::now()) {
+        if (!fd_) {
+            throw error(path);
+        }
+        struct stat st;
+        if (::fstat(int(fd_.get()), &st) != 0) {
+            throw error("fstat");
+        }
+        capacity_ = std::size_t(st.st_size);
+        if (capacity_ > max_size || max_size < header_size) {
+            throw std::length_error("mapped_append_log: max_size exceeded");
+        }
+
+        mem_ = make_mapped_mem(nullptr, max_size, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_NORESERVE, int(fd_.get()), 0);
+        if (!mem_) {
+            throw error("mmap");
+        }
+
+        if (capacity_ == 0) { // new: the header must be durable before any record
+            grow(header_size);
+            std::memcpy(head()->magic, magic, sizeof(magic));
+            head()->length = 0;
+            write_back(0, header_size);
+        } else if (capacity_ < header_size ||
+                   std::memcmp(head()->magic, magic, sizeof(magic)) != 0 ||
+                   head()->length > capacity_ - header_size) {
+            throw std::runtime_error(std::string(path) + ": not a mapped_append_log");
+        }
+        size_ = synced_ = std::size_t(head()->length);
+    }
+
+    mapped_append_log(mapped_append_log&&) = default;
+
+    ~mapped_append_log() {
+        if (!mem_) {
+            return; // moved from
+        }
+        try {
+            sync();
+        } catch (const std::system_error&) {
+            // nothing sensible to do in a destructor
+        }
+        ::ftruncate(int(fd_.get()), off_t(header_size + synced_)); // give the slack back
+    }
+
+    /// Writable space for `n` more bytes, right in the page cache.
+    /// Fill it, then `commit()` what was written.
+    [[nodiscard]] std::span<std::byte> prepare(std::size_t n) {
+        if (header_size + size_ + n > capacity_) {
+            grow(header_size + size_ + n);
+        }
+        return {base() + size_, n};
+    }
+
+    void commit(std::size_t n) {
+        size_ += n;
+        maybe_sync();
+    }
+
+    /// Returns the offset the record was written at
+    std::size_t append(std::span<const std::byte> bytes) {
+        auto dst = prepare(bytes.size());
+        std::memcpy(dst.data(), bytes.data(), bytes.size());
+        auto offset = size_;
+        commit(bytes.size());
+        return offset;
+    }
+
+    std::size_t append(std::string_view s) {
+        return append(std::as_bytes(std::span{s}));
+    }
+
+    /// Make everything appended so far durable: the records, then the
+    /// length that covers them. Two write-backs, since a single one could
+    /// store the new length before the records.
+    void sync() {
+        if (synced_ == size_) {
+            return;
+        }
+        write_back(header_size + synced_, header_size + size_);
+        head()->length = size_;
+        write_back(0, header_size);
+        synced_ = size_;
+        last_sync_ = std::chrono::steady_clock::now();
+    }
+
+    std::span<const std::byte> data() const noexcept {
+        return {base(), size_};
+    }
+    std::size_t size() const noexcept {
+        return size_;
+    }
+    /// File size, header included
+    std::size_t capacity() const noexcept {
+        return capacity_;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "append_log_test.bin";
+    std::remove(path.c_str());
+
+    const std::byte* first_record = nullptr;
+    {
+        mapped_append_log log{path.c_str(), std::size_t(1) << 30,
+                              {.every_bytes = 4 << 20,
+                               .every = std::chrono::milliseconds(50)}};
+        auto t0 = std::chrono::steady_clock::now();
+        for (int i = 0; i < 1'000'000; ++i) {
+            // Zero-copy: format straight into the mapping
+            auto dst = log.prepare(32);
+            int n = std::snprintf(reinterpret_cast<char*>(dst.data()),
+                                  dst.size(), "record %d\n", i);
+            log.commit(std::size_t(n));
+            if (i == 0) {
+                first_record = log.data().data();
+            }
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        std::cout << log.size() << " bytes (capacity " << log.capacity()
+                  << ") in "
+                  << std::chrono::duration<double, std::milli>(t1 - t0).count()
+                  << " ms\n";
+        // Growth never moved the mapping
+        std::cout << (first_record == log.data().data() ? "stable" : "MOVED")
+                  << '\n';
+    }
+    {
+        mapped_append_log log{path.c_str()};
+        std::string_view text{reinterpret_cast<const char*>(log.data().data()),
+                              log.size()};
+        std::cout << "reopened: " << log.size() << " bytes, starts with "
+                  << text.substr(0, text.find('\n')) << '\n';
+        log.append("one more\n");
+    }
+    {
+        // A crash: no destructor, so the file keeps its slack, and the
+        // last record was never synced
+        std::size_t before = mapped_append_log{path.c_str()}.size();
+        if (::fork() == 0) {
+            mapped_append_log log{path.c_str()};
+            log.append("synced\n");
+            log.sync();
+            log.append("not synced\n");
+            ::_exit(0);
+        }
+        ::wait(nullptr);
+        struct stat st;
+        ::stat(path.c_str(), &st);
+        mapped_append_log log{path.c_str()};
+        std::string_view text{reinterpret_cast<const char*>(log.data().data()),
+                              log.size()};
+        bool ok = log.size() == before + 7 && text.ends_with("one more\nsynced\n");
+        std::cout << "after a crash: " << log.size() << " bytes of a "
+                  << st.st_size << "-byte file, "
+                  << (ok ? "up to the last sync" : "WRONG") << '\n';
+    }
+
+    if (argc <= 1) {
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,162 @@
+#include "async_log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <x86intrin.h>
+
+/// Per-call latencies in TSC ticks, reported in ns
+class histogram {
+    std::vector<std::uint64_t> ticks_;
+
+public:
+    explicit histogram(std::size_t n) {
+        ticks_.reserve(n);
+    }
+    void add(std::uint64_t t) {
+        ticks_.push_back(t);
+    }
+    void report(const char* name, double ns_per_tick) {
+        std::sort(ticks_.begin(), ticks_.end());
+        auto at = [&](double q) {
+            return double(ticks_[std::size_t(q * double(ticks_.size() - 1))]) * ns_per_tick;
+        };
+        println(STDERR_FILENO,
+                "{}: p50 {:>6.0f} ns  p90 {:>6.0f}  p99 {:>7.0f}  p99.9 {:>7.0f}  max {:>9.0f}",
+                name, at(0.5), at(0.9), at(0.99), at(0.999), at(1.0));
+        // Power-of-two buckets
+        std::size_t i = 0;
+        for (double lo = 0, hi = 16; i < ticks_.size(); lo = hi, hi *= 2) {
+            std::size_t n = 0;
+            for (; i < ticks_.size() && double(ticks_[i]) * ns_per_tick < hi; ++i) {
+                ++n;
+            }
+            if (n > 0) {
+                println(STDERR_FILENO, "  {:>8.0f} - {:<8.0f} ns {:>8} {}", lo, hi, n,
+                        std::string(std::size_t(60.0 * double(n) / double(ticks_.size())) + 1,
+                                    '#'));
+            }
+        }
+    }
+};
+
+double ns_per_tick() {
+    auto t0 = std::chrono::steady_clock::now();
+    auto c0 = __rdtsc();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto c1 = __rdtsc();
+    auto t1 = std::chrono::steady_clock::now();
+    return double(std::chrono::nanoseconds(t1 - t0).count()) / double(c1 - c0);
+}
+
+bool check() {
+    int p[2];
+    if (::pipe(p) != 0) {
+        return false;
+    }
+    std::string out;
+    std::jthread reader([&] { // drains the pipe while the logger writes to it
+        char buf[4096];
+        for (ssize_t n; (n = ::read(p[0], buf, sizeof(buf))) > 0;) {
+            out.append(buf, std::size_t(n));
+        }
+    });
+    {
+        async_logger log{{.fd = p[1], .ring_bytes = 4096, .block_when_full = true,
+                          .timestamps = false}};
+        std::vector<std::jthread> threads;
+        for (int t = 0; t < 3; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 10'000; ++i) {
+                    log.log("t{} {} {:.1f}", t, i, i * 0.5);
+                }
+            });
+        }
+    }
+    ::close(p[1]);
+    reader.join();
+    ::close(p[0]);
+
+    // Every line, in order within each thread
+    int next[3] = {};
+    std::size_t lines = 0;
+    for (std::size_t b = 0, e; (e = out.find('\n', b)) != std::string::npos; b = e + 1) {
+        std::string line = out.substr(b, e - b);
+        int t = line[1] - '0';
+        if (line != fmt_lib::format("t{} {} {:.1f}", t, next[t], next[t] * 0.5)) {
+            println(STDERR_FILENO, "UNEXPECTED: {}", line);
+            return false;
+        }
+        ++next[t];
+        ++lines;
+    }
+    return lines == 30'000;
+}
+
+/// A thread keeps one ring per logger, and an exited thread's ring goes
+bool check_rings() {
+    int null = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    bool ok;
+    {
+        async_logger a{{.fd = null}}, b{{.fd = null}};
+        for (int i = 0; i < 2000; ++i) {
+            (i % 2 ? a : b).log("{}", i);
+        }
+        ok = a.rings() == 1 && b.rings() == 1;
+        for (int t = 0; t < 8; ++t) {
+            std::jthread([&] { a.log("short-lived"); });
+        }
+        ok = ok && a.rings() >= 1;
+        for (int i = 0; i < 1000 && a.rings() > 1; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ok = ok && a.rings() == 1;
+    }
+    ::close(null);
+    return ok;
+}
+
+int main() {
+    bool ok = check();
+    println(STDERR_FILENO, "check: {}", ok ? "all lines, in order per thread" : "FAILED");
+    bool rings_ok = check_rings();
+    println(STDERR_FILENO, "rings: {}",
+            rings_ok ? "one per thread and logger, reclaimed at exit" : "FAILED");
+    ok = ok && rings_ok;
+
+    double tick = ns_per_tick();
+    int null = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    constexpr int n = 200'000;
+
+    histogram sync{n};
+    for (int i = 0; i < n; ++i) {
+        auto c0 = __rdtsc();
+        print(null, "order {} filled at {:.2f} qty {}\n", i, i * 0.01, i % 100);
+        sync.add(__rdtsc() - c0);
+    }
+    sync.report("print (sync)", tick);
+
+    for (bool stamps : {true, false}) {
+        histogram async{n};
+        {
+            async_logger log{{.fd = null, .timestamps = stamps}};
+            for (int i = 0; i < n; ++i) {
+                auto c0 = __rdtsc();
+                log.log("order {} filled at {:.2f} qty {}", i, i * 0.01, i % 100);
+                async.add(__rdtsc() - c0);
+                if (i % 1000 == 999) {
+                    // Bursts, with gaps the worker can drain in
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+            }
+        }
+        async.report(stamps ? "async_logger" : "async_logger, no timestamps", tick);
+    }
+    ::close(null);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,373 @@
+#pragma once
+
+// Asynchronous logging: the calling thread copies the format string
+// pointer and the arguments' bytes into its own ring; a background thread
+// formats and writes, one write(2) per sweep over all rings.
+//
+//   async_logger log{{.fd = STDERR_FILENO}};
+//   log.log("order {} filled at {}", id, px);   // checked at compile time
+//
+// Arguments must be trivially copyable, and can't point to text: the
+// formatting happens later, when a char* or string_view may dangle.
+// Order is kept within a thread, not across threads; lines carry the
+// caller's timestamp (if enabled) to sort by.
+
+#include "print.hpp"
+#include "round.hpp"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+struct log_options {
+    int fd = STDERR_FILENO;
+    std::size_t ring_bytes = 1 << 20; // per thread, a power of two
+    bool block_when_full = false;     // otherwise drop and count
+    bool timestamps = true;           // one steady_clock read per call
+    std::chrono::microseconds idle_sleep{200};
+};
+
+namespace log_detail {
+
+template <class T>
+inline constexpr bool is_text_pointer =
+    std::is_pointer_v<T> &&
+    (std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, char> ||
+     std::is_same_v<std::remove_cv_t<std::remove_pointer_t<T>>, wchar_t>);
+
+template <class T>
+inline constexpr bool loggable =
+    std::is_trivially_copyable_v<T> && !is_text_pointer<T> &&
+    !std::is_same_v<T, std::string_view>;
+
+using format_fn = void (*)(std::string& out, std::string_view fmt, const std::byte* args);
+
+struct record {
+    std::uint32_t size; // of the whole record, a multiple of 8
+    std::uint32_t fmt_size;
+    format_fn format;   // nullptr: padding up to the end of the ring
+    const char* fmt;
+    std::int64_t time;  // ns, steady_clock
+};
+
+/// Arguments packed back to back, unaligned; memcpy in and out
+template <class... Args>
+struct codec {
+    static constexpr std::size_t size = (std::size_t{0} + ... + sizeof(Args));
+
+    static void encode(std::byte* p, const Args&... args) noexcept {
+        ((std::memcpy(p, &args, sizeof(Args)), p += sizeof(Args)), ...);
+    }
+
+    template <class T>
+    static T load(const std::byte*& p) noexcept {
+        std::array<std::byte, sizeof(T)> bytes;
+        std::memcpy(bytes.data(), p, sizeof(T));
+        p += sizeof(T);
+        return std::bit_cast<T>(bytes);
+    }
+
+    static void format(std::string& out, std::string_view fmt,
+                       [[maybe_unused]] const std::byte* p) {
+        // Braced init: evaluated left to right, in encode's order
+        std::tuple<Args...> args{load<Args>(p)...};
+        std::apply(
+            [&](auto&... a) {
+                fmt_lib::vformat_to(std::back_inserter(out), fmt,
+                                    fmt_lib::make_format_args(a...));
+            },
+            args);
+    }
+};
+
+// Not std::hardware_destructive_interference_size: GCC warns about it
+// in headers, since its value can change with -mtune
+inline constexpr std::size_t cache_line = 64;
+
+/// Single producer (the owning thread), single consumer (the logger's thread)
+struct ring {
+    explicit ring(std::size_t bytes)
+        : capacity(bytes), data(std::make_unique<std::byte[]>(bytes)) {}
+
+    const std::size_t capacity;
+    const std::unique_ptr<std::byte[]> data;
+
+    alignas(cache_line) std::atomic<std::uint64_t> head{0};
+    std::uint64_t cached_tail = 0; // producer's last look at tail
+    std::atomic<std::uint64_t> dropped{0};
+
+    alignas(cache_line) std::atomic<std::uint64_t> tail{0};
+    std::uint64_t reported_drops = 0; // consumer's
+
+    std::atomic<bool> retired{false}; // its thread exited: drain, then free
+    std::atomic<bool> orphaned{false}; // its logger is gone
+};
+
+inline std::atomic<std::uint64_t> next_logger_id{1};
+
+/// A thread's rings, one per logger it has logged to. Shared with the
+/// logger, so that either may go first; the thread's exit retires them.
+struct thread_rings {
+    struct entry {
+        std::uint64_t logger;
+        std::shared_ptr<ring> r;
+    };
+    std::vector<entry> entries;
+    entry* last = nullptr; // most threads log to one logger
+
+    ~thread_rings() {
+        for (auto& e : entries) {
+            e.r->retired.store(true, std::memory_order_release);
+        }
+    }
+
+    ring* find(std::uint64_t logger) noexcept {
+        if (last != nullptr && last->logger == logger) {
+            return last->r.get();
+        }
+        for (auto& e : entries) {
+            if (e.logger == logger) {
+                last = &e;
+                return e.r.get();
+            }
+        }
+        return nullptr;
+    }
+
+    ring* add(std::uint64_t logger, std::shared_ptr<ring> r) {
+        // Logger ids aren't reused: entries of destroyed loggers can go
+        std::erase_if(entries, [](const entry& e) {
+            return e.r->orphaned.load(std::memory_order_relaxed);
+        });
+        entries.push_back({logger, std::move(r)});
+        last = &entries.back();
+        return last->r.get();
+    }
+};
+
+inline thread_local thread_rings my_rings;
+
+} // namespace log_detail
+
+class async_logger {
+public:
+    explicit async_logger(log_options opt = {})
+        : opt_((assert(std::has_single_bit(opt.ring_bytes)), opt)),
+          id_(log_detail::next_logger_id++),
+          start_(std::chrono::steady_clock::now()),
+          worker_([this](std::stop_token st) { run(st); }) {}
+
+    ~async_logger() {
+        worker_.request_stop();
+        worker_.join(); // the worker drains everything before it returns
+        for (auto& r : rings_) {
+            r->orphaned.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    async_logger(const async_logger&) = delete;
+    async_logger& operator=(const async_logger&) = delete;
+
+    /// Queue one line (a newline is added). False if the ring was full
+    /// and the line dropped; see log_options::block_when_full.
+    template <class... Args>
+    bool log(print_detail::format_string<const Args&...> fmt, const Args&... args) {
+        static_assert((log_detail::loggable<Args> && ...),
+                      "log arguments must be trivially copyable and not point to text");
+        using codec = log_detail::codec<Args...>;
+        constexpr std::size_t need =
+            round_up<8>(sizeof(log_detail::record) + codec::size);
+
+        auto& r = my_ring();
+        if (need > r.capacity) {
+            r.dropped.fetch_add(1, std::memory_order_relaxed);
+            return false; // would never fit
+        }
+        std::uint64_t head = r.head.load(std::memory_order_relaxed);
+        std::size_t pos = std::size_t(head & (r.capacity - 1));
+        std::size_t pad = r.capacity - pos < need ? r.capacity - pos : 0;
+        while (head + pad + need - r.cached_tail > r.capacity) {
+            r.cached_tail = r.tail.load(std::memory_order_acquire);
+            if (head + pad + need - r.cached_tail <= r.capacity) {
+                break;
+            }
+            if (!opt_.block_when_full) {
+                r.dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        if (pad > 0) {
+            // The consumer skips a tail shorter than a record by itself
+            if (pad >= sizeof(log_detail::record)) {
+                log_detail::record skip{};
+                std::memcpy(r.data.get() + pos, &skip, sizeof(skip));
+            }
+            head += pad;
+            pos = 0;
+        }
+
+        std::string_view f = print_detail::view(fmt);
+        log_detail::record rec{
+            std::uint32_t(need),
+            std::uint32_t(f.size()),
+            &codec::format,
+            f.data(),
+            opt_.timestamps ? std::chrono::steady_clock::now().time_since_epoch().count() : 0,
+        };
+        std::byte* p = r.data.get() + pos;
+        std::memcpy(p, &rec, sizeof(rec));
+        codec::encode(p + sizeof(rec), args...);
+        r.head.store(head + need, std::memory_order_release);
+        return true;
+    }
+
+    /// Returns once everything queued before the call (by any thread) is written
+    void flush() {
+        std::vector<std::pair<std::shared_ptr<log_detail::ring>, std::uint64_t>> marks;
+        {
+            std::lock_guard lock{mutex_};
+            for (auto& r : rings_) {
+                marks.emplace_back(r, r->head.load(std::memory_order_acquire));
+            }
+        }
+        for (auto& [r, head] : marks) {
+            while (r->tail.load(std::memory_order_acquire) < head) {
+                std::this_thread::sleep_for(opt_.idle_sleep);
+            }
+        }
+    }
+
+    /// Rings in use: one per thread that has logged here and not exited
+    /// (or whose lines aren't written yet)
+    std::size_t rings() const {
+        std::lock_guard lock{mutex_};
+        return rings_.size();
+    }
+
+private:
+    /// This thread's ring for this logger, made on first use. The id, not
+    /// the address, tells loggers apart: an address can be reused.
+    log_detail::ring& my_ring() {
+        auto& mine = log_detail::my_rings;
+        if (auto* r = mine.find(id_)) [[likely]] {
+            return *r;
+        }
+        auto r = std::make_shared<log_detail::ring>(opt_.ring_bytes);
+        {
+            std::lock_guard lock{mutex_};
+            rings_.push_back(r);
+        }
+        return *mine.add(id_, std::move(r));
+    }
+
+    /// Drop the rings whose threads have exited, once drained
+    void reap() {
+        std::lock_guard lock{mutex_};
+        std::erase_if(rings_, [](const std::shared_ptr<log_detail::ring>& r) {
+            // retired (acquire) first: then head and dropped are final
+            return r->retired.load(std::memory_order_acquire) &&
+                   r->head.load(std::memory_order_relaxed) ==
+                       r->tail.load(std::memory_order_relaxed) &&
+                   r->dropped.load(std::memory_order_relaxed) == r->reported_drops;
+        });
+    }
+
+    /// Format what's in `r` into out_; returns the new tail, not yet published
+    std::uint64_t consume(log_detail::ring& r) {
+        std::uint64_t tail = r.tail.load(std::memory_order_relaxed);
+        std::uint64_t head = r.head.load(std::memory_order_acquire);
+        while (tail < head) {
+            std::size_t pos = std::size_t(tail & (r.capacity - 1));
+            std::size_t left = r.capacity - pos;
+            log_detail::record rec;
+            if (left < sizeof(rec)) {
+                tail += left;
+                continue;
+            }
+            std::memcpy(&rec, r.data.get() + pos, sizeof(rec));
+            if (rec.format == nullptr) {
+                tail += left;
+                continue;
+            }
+            if (opt_.timestamps) {
+                auto since = std::chrono::nanoseconds(rec.time) - start_.time_since_epoch();
+                fmt_lib::format_to(std::back_inserter(out_), "[{:>12.6f}] ",
+                                   std::chrono::duration<double>(since).count());
+            }
+            rec.format(out_, {rec.fmt, rec.fmt_size}, r.data.get() + pos + sizeof(rec));
+            out_ += '\n';
+            tail += rec.size;
+        }
+        if (auto d = r.dropped.load(std::memory_order_relaxed); d != r.reported_drops) {
+            fmt_lib::format_to(std::back_inserter(out_), "[{} lines dropped]\n",
+                               d - r.reported_drops);
+            r.reported_drops = d;
+        }
+        return tail;
+    }
+
+    void run(std::stop_token st) {
+        std::vector<log_detail::ring*> rings;
+        std::vector<std::uint64_t> tails;
+        for (;;) {
+            // Read the stop request first: a sweep after it sees everything
+            bool stopping = st.stop_requested();
+            {
+                std::lock_guard lock{mutex_};
+                rings.clear();
+                for (auto& r : rings_) {
+                    rings.push_back(r.get());
+                }
+            }
+            tails.clear();
+            for (auto* r : rings) {
+                tails.push_back(consume(*r));
+            }
+            if (!out_.empty()) {
+                print_detail::write_all(opt_.fd, out_.data(), out_.size());
+                out_.clear();
+            }
+            // Only now can producers reuse the space, and flush() return
+            for (std::size_t i = 0; i < rings.size(); ++i) {
+                rings[i]->tail.store(tails[i], std::memory_order_release);
+            }
+            bool idle = true;
+            for (std::size_t i = 0; i < rings.size(); ++i) {
+                idle = idle && rings[i]->head.load(std::memory_order_relaxed) == tails[i];
+            }
+            reap(); // `rings` may dangle from here
+            if (stopping) {
+                return;
+            }
+            if (idle) {
+                std::this_thread::sleep_for(opt_.idle_sleep);
+            }
+        }
+    }
+
+    const log_options opt_;
+    const std::uint64_t id_;
+    const std::chrono::steady_clock::time_point start_;
+
+    mutable std::mutex mutex_; // guards rings_ (registration and reaping)
+    std::vector<std::shared_ptr<log_detail::ring>> rings_;
+    std::string out_; // the worker's
+
+    std::jthread worker_; // last: starts after everything above exists
+};
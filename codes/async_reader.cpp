@@ -0,0 +1,479 @@
+#include "raii.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+/// A finished read: which buffer slot, and how many bytes (or -errno)
+struct io_completion {
+    unsigned slot;
+    long result;
+};
+
+/// Where reads actually happen. `submit` may only queue the request;
+/// `wait` flushes anything queued and blocks until one read finishes.
+class io_backend {
+public:
+    virtual ~io_backend() = default;
+    virtual void submit(unsigned slot, std::byte* buf, size_t len,
+                        off_t offset) = 0;
+    virtual io_completion wait() = 0;
+    virtual const char* name() const noexcept = 0;
+};
+
+/// io_uring without liburing: the rings are plain shared memory,
+/// which is exactly what `mapped_mem_ptr` is for.
+class uring_backend : public io_backend {
+    unique_fd ring_fd_;
+    int file_fd_;
+    mapped_mem_ptr sq_ring_;
+    mapped_mem_ptr cq_ring_; // null when the kernel maps both rings at once
+    mapped_mem_ptr sqes_mem_;
+
+    unsigned* sq_tail_;
+    unsigned sq_mask_;
+    unsigned* sq_array_;
+    io_uring_sqe* sqes_;
+    unsigned* cq_head_;
+    unsigned* cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe* cqes_;
+
+    unsigned to_submit_{};
+
+    uring_backend() = default;
+
+    static std::byte* at(const mapped_mem_ptr& m, unsigned off) noexcept {
+        return static_cast<std::byte*>(m.get()) + off;
+    }
+
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, int(ring_fd_.get()),
+                                          to_submit, min_complete, flags,
+                                          nullptr, 0));
+    }
+
+public:
+    /// Returns null if io_uring is unavailable (old kernel, seccomp, ...)
+    static std::unique_ptr<uring_backend> make(int file_fd, unsigned depth,
+                                               std::span<const iovec> buffers) {
+        io_uring_params p{};
+        auto ring_fd =
+            make_unique_fd(int(::syscall(__NR_io_uring_setup, depth, &p)));
+        if (!ring_fd) {
+            return nullptr;
+        }
+
+        size_t sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        size_t cq_size = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = p.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap) {
+            sq_size = cq_size = std::max(sq_size, cq_size);
+        }
+
+        std::unique_ptr<uring_backend> r{new uring_backend};
+        r->sq_ring_ = make_mapped_mem(nullptr, sq_size, PROT_READ | PROT_WRITE,
+                                      MAP_SHARED | MAP_POPULATE, int(ring_fd.get()),
+                                      IORING_OFF_SQ_RING);
+        if (!single_mmap) {
+            r->cq_ring_ = make_mapped_mem(
+                nullptr, cq_size, PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, int(ring_fd.get()), IORING_OFF_CQ_RING);
+        }
+        r->sqes_mem_ = make_mapped_mem(
+            nullptr, p.sq_entries * sizeof(io_uring_sqe),
+            PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+            int(ring_fd.get()), IORING_OFF_SQES);
+        if (!r->sq_ring_ || (!single_mmap && !r->cq_ring_) || !r->sqes_mem_) {
+            return nullptr;
+        }
+
+        // Fixed buffers: the kernel pins them once instead of on every read
+        if (::syscall(__NR_io_uring_register, int(ring_fd.get()),
+                      IORING_REGISTER_BUFFERS, buffers.data(),
+                      unsigned(buffers.size())) < 0) {
+            return nullptr;
+        }
+
+        const auto& cq = single_mmap ? r->sq_ring_ : r->cq_ring_;
+        r->sq_tail_ = reinterpret_cast<unsigned*>(at(r->sq_ring_, p.sq_off.tail));
+        r->sq_mask_ = *reinterpret_cast<unsigned*>(at(r->sq_ring_, p.sq_off.ring_mask));
+        r->sq_array_ = reinterpret_cast<unsigned*>(at(r->sq_ring_, p.sq_off.array));
+        r->sqes_ = static_cast<io_uring_sqe*>(r->sqes_mem_.get());
+        r->cq_head_ = reinterpret_cast<unsigned*>(at(cq, p.cq_off.head));
+        r->cq_tail_ = reinterpret_cast<unsigned*>(at(cq, p.cq_off.tail));
+        r->cq_mask_ = *reinterpret_cast<unsigned*>(at(cq, p.cq_off.ring_mask));
+        r->cqes_ = reinterpret_cast<io_uring_cqe*>(at(cq, p.cq_off.cqes));
+
+        r->ring_fd_ = std::move(ring_fd);
+        r->file_fd_ = file_fd;
+        return r;
+    }
+
+    void submit(unsigned slot, std::byte* buf, size_t len,
+                off_t offset) override {
+        // We are the only producer, so our own tail needs no ordering
+        unsigned tail = std::atomic_ref(*sq_tail_).load(std::memory_order_relaxed);
+        unsigned index = tail & sq_mask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_READ_FIXED;
+        sqe.fd = file_fd_;
+        sqe.addr = reinterpret_cast<std::uint64_t>(buf);
+        sqe.len = static_cast<std::uint32_t>(len);
+        sqe.off = static_cast<std::uint64_t>(offset);
+        sqe.buf_index = static_cast<std::uint16_t>(slot);
+        sqe.user_data = slot;
+        sq_array_[index] = index;
+        std::atomic_ref(*sq_tail_).store(tail + 1, std::memory_order_release);
+        ++to_submit_;
+    }
+
+    io_completion wait() override {
+        for (;;) {
+            unsigned head = std::atomic_ref(*cq_head_).load(std::memory_order_relaxed);
+            if (head != std::atomic_ref(*cq_tail_).load(std::memory_order_acquire)) {
+                const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+                io_completion c{unsigned(cqe.user_data), cqe.res};
+                std::atomic_ref(*cq_head_).store(head + 1, std::memory_order_release);
+                return c;
+            }
+            // One syscall both submits the whole batch and waits
+            int n = enter(to_submit_, 1, IORING_ENTER_GETEVENTS);
+            if (n < 0 && errno != EINTR) {
+                throw std::system_error(errno, std::system_category(),
+                                        "io_uring_enter");
+            }
+            if (n > 0) {
+                to_submit_ -= unsigned(n);
+            }
+        }
+    }
+
+    const char* name() const noexcept override {
+        return "io_uring";
+    }
+};
+
+/// Reads finished by the pool, for one backend to collect
+class completion_queue {
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::deque<io_completion> done_;
+
+public:
+    void push(io_completion c) {
+        // Notify under the lock: once the last read is popped, the owner
+        // may destroy the queue
+        std::lock_guard lk{mtx_};
+        done_.push_back(c);
+        cv_.notify_one();
+    }
+
+    io_completion pop() {
+        std::unique_lock lk{mtx_};
+        cv_.wait(lk, [&] { return !done_.empty(); });
+        auto c = done_.front();
+        done_.pop_front();
+        return c;
+    }
+};
+
+/// Threads doing blocking `pread`, one pool for the whole process: the
+/// number of threads is fixed, not multiplied by the number of files.
+class pread_pool {
+public:
+    struct request {
+        int fd;
+        unsigned slot;
+        std::byte* buf;
+        size_t len;
+        off_t offset;
+        completion_queue* done;
+    };
+
+    static constexpr unsigned threads = 8;
+
+    static pread_pool& shared() {
+        static pread_pool pool;
+        return pool;
+    }
+
+    void submit(const request& req) {
+        {
+            std::lock_guard lk{mtx_};
+            requests_.push_back(req);
+        }
+        cv_.notify_one();
+    }
+
+private:
+    std::mutex mtx_;
+    std::condition_variable_any cv_;
+    std::deque<request> requests_;
+    std::vector<std::jthread> workers_; // last, so that it is joined first
+
+    pread_pool() {
+        for (unsigned i = 0; i < threads; ++i) {
+            workers_.emplace_back([this](std::stop_token st) { work(st); });
+        }
+    }
+
+    void work(std::stop_token st) {
+        for (;;) {
+            request req;
+            {
+                std::unique_lock lk{mtx_};
+                if (!cv_.wait(lk, st, [&] { return !requests_.empty(); })) {
+                    return;
+                }
+                req = requests_.front();
+                requests_.pop_front();
+            }
+            long n = ::pread(req.fd, req.buf, req.len, req.offset);
+            req.done->push({req.slot, n < 0 ? -errno : n});
+        }
+    }
+};
+
+/// Fallback: blocking reads on the shared pread_pool. The owner must
+/// collect every read it submitted before destroying this.
+class pread_pool_backend : public io_backend {
+    int file_fd_;
+    completion_queue done_;
+
+public:
+    explicit pread_pool_backend(int file_fd) : file_fd_(file_fd) {
+    }
+
+    void submit(unsigned slot, std::byte* buf, size_t len,
+                off_t offset) override {
+        pread_pool::shared().submit({file_fd_, slot, buf, len, offset, &done_});
+    }
+
+    io_completion wait() override {
+        return done_.pop();
+    }
+
+    const char* name() const noexcept override {
+        return "pread pool";
+    }
+};
+
+/// Reads a whole file with up to `depth` block-sized reads in flight.
+/// Blocks are handed out in completion order, each tagged with its offset.
+/// A block's buffer stays valid until the next call to `next()`.
+class async_reader {
+public:
+    struct chunk {
+        off_t offset;
+        std::span<const std::byte> data;
+    };
+
+private:
+    struct slot_state {
+        off_t offset;
+        size_t want;
+        size_t filled;
+    };
+
+    static constexpr size_t alignment = 4096; // also good for O_DIRECT
+
+    unique_fd file_;
+    size_t block_size_;
+    off_t file_size_;
+    off_t next_offset_{};
+    aligned_bytes_ptr storage_;
+    std::vector<slot_state> slots_;
+    std::unique_ptr<io_backend> backend_;
+    unsigned in_flight_{};
+    std::optional<unsigned> returned_; // the slot the caller is looking at
+
+    std::byte* buffer(unsigned slot) const noexcept {
+        return storage_.get() + slot * block_size_;
+    }
+
+    void issue(unsigned slot) {
+        auto& s = slots_[slot];
+        backend_->submit(slot, buffer(slot) + s.filled, s.want - s.filled,
+                         s.offset + off_t(s.filled));
+        ++in_flight_;
+    }
+
+    bool start(unsigned slot) {
+        if (next_offset_ >= file_size_) {
+            return false;
+        }
+        auto want = std::min<size_t>(block_size_, size_t(file_size_ - next_offset_));
+        slots_[slot] = {next_offset_, want, 0};
+        next_offset_ += off_t(want);
+        issue(slot);
+        return true;
+    }
+
+public:
+    async_reader(unique_fd file, size_t block_size = 1 << 20, unsigned depth = 8)
+        : file_(std::move(file)),
+          block_size_((block_size + alignment - 1) / alignment * alignment),
+          storage_(make_aligned_bytes(alignment, block_size_ * depth)),
+          slots_(depth) {
+        if (!storage_) {
+            throw std::bad_alloc();
+        }
+        struct stat st;
+        if (::fstat(int(file_.get()), &st) != 0) {
+            throw std::system_error(errno, std::system_category(), "fstat");
+        }
+        file_size_ = st.st_size;
+
+        std::vector<iovec> iov(depth);
+        for (unsigned i = 0; i < depth; ++i) {
+            iov[i] = {buffer(i), block_size_};
+        }
+        backend_ = uring_backend::make(int(file_.get()), depth, iov);
+        if (!backend_) {
+            backend_ = std::make_unique<pread_pool_backend>(int(file_.get()));
+        }
+
+        for (unsigned i = 0; i < depth && start(i); ++i) {
+        }
+    }
+
+    // In-flight reads point into our buffers
+    async_reader(const async_reader&) = delete;
+    async_reader& operator=(const async_reader&) = delete;
+
+    /// Waits out the reads in flight. If waiting fails, the kernel may
+    /// still write into our buffers, so they can't be freed: this reports
+    /// the error and aborts, rather than letting it reach the noexcept.
+    ~async_reader() {
+        try {
+            while (in_flight_ > 0) {
+                backend_->wait();
+                --in_flight_;
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "~async_reader: " << e.what() << ", with " << in_flight_
+                      << " reads in flight; aborting\n";
+            std::abort();
+        }
+    }
+
+    const char* backend_name() const noexcept {
+        return backend_->name();
+    }
+
+    std::optional<chunk> next() {
+        if (returned_) {
+            start(*returned_); // recycle the buffer the caller is done with
+            returned_.reset();
+        }
+        while (in_flight_ > 0) {
+            auto [slot, res] = backend_->wait();
+            --in_flight_;
+            if (res < 0) {
+                throw std::system_error(int(-res), std::system_category(), "read");
+            }
+            auto& s = slots_[slot];
+            s.filled += size_t(res);
+            if (res != 0 && s.filled < s.want) {
+                issue(slot); // short read, ask for the rest
+                continue;
+            }
+            returned_ = slot;
+            return chunk{s.offset, {buffer(slot), s.filled}};
+        }
+        return std::nullopt;
+    }
+
+    // Input range over the chunks, in the style of line_iterator
+    class iterator {
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = chunk;
+
+    private:
+        async_reader* r_;
+        std::optional<chunk> value_;
+
+    public:
+        explicit iterator(async_reader& r) : r_(&r), value_(r.next()) {
+        }
+        const chunk& operator*() const {
+            return *value_;
+        }
+        iterator& operator++() {
+            value_ = r_->next();
+            return *this;
+        }
+        void operator++(int) {
+            ++*this;
+        }
+        bool operator==(std::default_sentinel_t) const {
+            return !value_;
+        }
+    };
+
+    iterator begin() {
+        return iterator{*this};
+    }
+    std::default_sentinel_t end() const noexcept {
+        return {};
+    }
+};
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "async_reader_test.bin";
+    if (argc <= 1) {
+        file_ptr fp{std::fopen(path.c_str(), "wb")};
+        for (int i = 0; i < (5 << 20) + 123; ++i) {
+            std::fputc(i * 31 % 251, fp.get());
+        }
+    }
+
+    auto fd = open_fd(path.c_str(), O_RDONLY);
+    if (!fd) {
+        std::perror(path.c_str());
+        return 1;
+    }
+
+    std::uint64_t bytes = 0, checksum = 0;
+    async_reader reader{std::move(fd), 256 << 10, 8};
+    for (const auto& [offset, data] : reader) {
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            checksum += std::uint64_t(data[i]) * std::uint64_t(offset + off_t(i) + 1);
+        }
+        bytes += data.size();
+    }
+    std::cout << reader.backend_name() << ": " << bytes << " bytes, checksum "
+              << checksum << '\n';
+
+    // Same checksum the blocking way
+    file_ptr fp{std::fopen(path.c_str(), "rb")};
+    std::uint64_t expected = 0, pos = 0;
+    for (int c; (c = std::fgetc(fp.get())) != EOF;) {
+        expected += std::uint64_t(c) * ++pos;
+    }
+    std::cout << (expected == checksum ? "ok" : "MISMATCH") << '\n';
+
+    if (argc <= 1) {
+        std::remove(path.c_str());
+    }
+    return expected == checksum ? 0 : 1;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+// Fixed-point decimal: an int64 count of 10^-Scale units.
+// decimal<2> holds cents, decimal<8> satoshis; 0.01 is exact, and
+// snapping to a decimal tick is integer rounding (round.hpp).
+
+#include "round.hpp"
+
+#include <compare>
+#include <cstdint>
+#include <cstdlib>
+#include <ostream>
+
+namespace detail {
+
+constexpr std::int64_t pow10(int n) noexcept {
+    std::int64_t r = 1;
+    while (n-- > 0) {
+        r *= 10;
+    }
+    return r;
+}
+
+} // namespace detail
+
+template <int Scale>
+class decimal {
+    static_assert(0 <= Scale && Scale <= 18, "10^Scale must fit in int64");
+
+    std::int64_t raw_{};
+
+public:
+    static constexpr int scale = Scale;
+    static constexpr std::int64_t one = detail::pow10(Scale); // raw value of 1
+
+    constexpr decimal() = default;
+
+    /// An integer number of units: decimal<2>{5} is 5.00
+    constexpr explicit decimal(std::int64_t units) noexcept : raw_(units * one) {}
+
+    /// In 10^-Scale: decimal<2>::from_raw(5) is 0.05
+    static constexpr decimal from_raw(std::int64_t raw) noexcept {
+        decimal d;
+        d.raw_ = raw;
+        return d;
+    }
+
+    /// The nearest decimal by default. x * 10^Scale is rounded once, so
+    /// a double that was meant to be a decimal (1.005, really 1.00499...)
+    /// can land on either side of a tie; pass `mode` to choose.
+    static decimal from_double(double x,
+                               rounding mode = rounding::nearest_ties_even) noexcept {
+        return from_raw(std::int64_t(round_to(x * double(one), 1.0, mode)));
+    }
+
+    constexpr std::int64_t raw() const noexcept {
+        return raw_;
+    }
+    constexpr double to_double() const noexcept {
+        return double(raw_) / double(one);
+    }
+
+    friend constexpr auto operator<=>(decimal, decimal) = default;
+
+    friend constexpr decimal operator+(decimal a, decimal b) noexcept {
+        return from_raw(a.raw_ + b.raw_);
+    }
+    friend constexpr decimal operator-(decimal a, decimal b) noexcept {
+        return from_raw(a.raw_ - b.raw_);
+    }
+    friend constexpr decimal operator-(decimal a) noexcept {
+        return from_raw(-a.raw_);
+    }
+    friend constexpr decimal operator*(decimal a, std::int64_t k) noexcept {
+        return from_raw(a.raw_ * k);
+    }
+    friend constexpr decimal operator*(std::int64_t k, decimal a) noexcept {
+        return from_raw(a.raw_ * k);
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, decimal d) {
+        auto mag = std::llabs(d.raw_ / one);
+        if (d.raw_ < 0) {
+            os << '-';
+        }
+        os << mag;
+        if constexpr (Scale > 0) {
+            auto frac = std::llabs(d.raw_ % one);
+            char digits[Scale + 1] = {};
+            for (int i = Scale - 1; i >= 0; --i, frac /= 10) {
+                digits[i] = char('0' + frac % 10);
+            }
+            os << '.' << digits;
+        }
+        return os;
+    }
+};
+
+/// x snapped to a multiple of `tick`, exactly, tick > 0
+template <int Scale>
+constexpr decimal<Scale> round_to(decimal<Scale> x, decimal<Scale> tick,
+                                  rounding mode) noexcept {
+    return decimal<Scale>::from_raw(round_to(x.raw(), tick.raw(), mode));
+}
+
+/// Same, with the tick as a precomputed divisor of raw units
+template <int Scale>
+constexpr decimal<Scale> round_to(decimal<Scale> x, const divisor<std::int64_t>& tick,
+                                  rounding mode) noexcept {
+    return decimal<Scale>::from_raw(round_to(x.raw(), tick, mode));
+}
@@ -0,0 +1,188 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+/// How the additions are done. The order of the additions never depends
+/// on the number of threads, so the result is bit-identical for any count.
+///
+/// Note: -ffast-math (-fassociative-math) voids all of this.
+enum class summation {
+    pairwise, // plain adds, in a fixed tree
+    neumaier, // compensated (improved Kahan), error independent of length
+};
+
+struct sum_policy {
+    unsigned threads = 1;
+    summation method = summation::pairwise;
+};
+
+namespace detail {
+
+// Fixed shape: the input is cut into blocks of `block_size` elements,
+// each block is summed by `lanes` interleaved accumulators
+// (lane j takes elements j, j + lanes, j + 2 * lanes, ...),
+// and then everything is combined by pairwise trees.
+inline constexpr std::size_t block_size = 4096;
+inline constexpr std::size_t lanes = 8; // 2 AVX / 1 AVX-512 register of doubles
+
+// A sum plus its running error term
+struct partial {
+    double s = 0;
+    double c = 0;
+};
+
+// Error-free transformation: a + b == s + e exactly
+inline partial two_sum(double a, double b) noexcept {
+    double s = a + b;
+    double bb = s - a;
+    double e = (a - (s - bb)) + (b - bb);
+    return {s, e};
+}
+
+inline partial combine(partial x, partial y, summation m) noexcept {
+    if (m == summation::pairwise) {
+        return {x.s + y.s, 0};
+    }
+    auto [s, e] = two_sum(x.s, y.s);
+    return {s, x.c + y.c + e};
+}
+
+// Pairwise tree over [0, n), always split the same way for a given n
+template <class F>
+partial tree(std::size_t first, std::size_t last, F leaf, summation m) {
+    if (last - first == 1) {
+        return leaf(first);
+    }
+    auto mid = first + (last - first) / 2;
+    return combine(tree(first, mid, leaf, m), tree(mid, last, leaf, m), m);
+}
+
+// Neumaier: like Kahan, but also right when |x| > |s|
+inline void neumaier_add(double& s, double& c, double x) noexcept {
+    double t = s + x;
+    c += std::abs(s) >= std::abs(x) ? (s - t) + x : (x - t) + s;
+    s = t;
+}
+
+// The independent lanes are what lets the compiler use packed adds;
+// with one accumulator it has to keep the scalar `addsd` chain.
+inline partial sum_block(std::span<const double> xs, summation m) noexcept {
+    std::array<double, lanes> s{}, c{};
+    std::size_t n = xs.size() / lanes * lanes;
+    if (m == summation::pairwise) {
+        for (std::size_t i = 0; i < n; i += lanes) {
+            for (std::size_t j = 0; j < lanes; ++j) {
+                s[j] += xs[i + j];
+            }
+        }
+        // The tail goes to the lanes in order, so it's part of the fixed shape
+        for (std::size_t i = n; i < xs.size(); ++i) {
+            s[i - n] += xs[i];
+        }
+    } else {
+        for (std::size_t i = 0; i < n; i += lanes) {
+            for (std::size_t j = 0; j < lanes; ++j) {
+                neumaier_add(s[j], c[j], xs[i + j]);
+            }
+        }
+        for (std::size_t i = n; i < xs.size(); ++i) {
+            neumaier_add(s[i - n], c[i - n], xs[i]);
+        }
+    }
+    return tree(0, lanes, [&](std::size_t j) { return partial{s[j], c[j]}; },
+                m);
+}
+
+} // namespace detail
+
+inline double sum(std::span<const double> xs, sum_policy policy = {}) {
+    using namespace detail;
+    if (xs.empty()) {
+        return 0;
+    }
+    std::size_t blocks = (xs.size() + block_size - 1) / block_size;
+    std::vector<partial> partials(blocks);
+
+    auto work = [&](std::size_t first, std::size_t last) {
+        for (std::size_t b = first; b < last; ++b) {
+            partials[b] = sum_block(xs.subspan(b * block_size).first(
+                                        std::min(block_size, xs.size() - b * block_size)),
+                                    policy.method);
+        }
+    };
+
+    // Threads only decide who computes which block, not how blocks combine
+    unsigned threads = std::clamp<unsigned>(policy.threads, 1, unsigned(blocks));
+    {
+        std::vector<std::jthread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back(work, blocks * t / threads, blocks * (t + 1) / threads);
+        }
+        work(0, blocks / threads);
+    }
+
+    auto total = tree(0, blocks, [&](std::size_t b) { return partials[b]; },
+                      policy.method);
+    return total.s + total.c;
+}
+
+int main() {
+    // Values across many magnitudes, with lots of cancellation
+    std::mt19937_64 gen{2024};
+    std::uniform_real_distribution<double> mant{-1, 1};
+    std::uniform_int_distribution<int> expo{-20, 20};
+    std::vector<double> nums(10'000'003);
+    for (auto& x : nums) {
+        x = std::ldexp(mant(gen), expo(gen));
+    }
+
+    // Reference, with a 64-bit mantissa
+    long double ref = 0;
+    for (double x : nums) {
+        ref += x;
+    }
+
+    auto time = [](auto f) {
+        auto t0 = std::chrono::steady_clock::now();
+        double r = f();
+        auto t1 = std::chrono::steady_clock::now();
+        return std::pair{r, std::chrono::duration<double, std::milli>(t1 - t0).count()};
+    };
+    auto show = [&](const char* name, std::pair<double, double> r) {
+        std::cout << name << ": " << std::setprecision(17) << r.first
+                  << std::setprecision(3) << " (error "
+                  << double(std::abs((long double)r.first - ref)) << "), "
+                  << r.second << " ms\n";
+    };
+
+    show("accumulate        ", time([&] { return std::accumulate(nums.begin(), nums.end(), 0.0); }));
+    show("reduce            ", time([&] { return std::reduce(nums.begin(), nums.end()); }));
+
+    for (auto method : {summation::pairwise, summation::neumaier}) {
+        std::uint64_t bits = 0;
+        for (unsigned threads : {1u, 2u, 3u, 4u, 7u, 16u}) {
+            auto r = time([&] { return sum(nums, {threads, method}); });
+            if (threads == 1) {
+                bits = std::bit_cast<std::uint64_t>(r.first);
+            } else if (bits != std::bit_cast<std::uint64_t>(r.first)) {
+                std::cout << "NOT DETERMINISTIC\n";
+                return 1;
+            }
+            if (threads == 1 || threads == 4) {
+                std::cout << (threads == 1 ? "1 thread,  " : "4 threads, ");
+                show(method == summation::pairwise ? "pairwise" : "neumaier", r);
+            }
+        }
+    }
+    std::cout << "bit-identical for 1, 2, 3, 4, 7, 16 threads\n";
+}
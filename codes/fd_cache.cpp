@@ -0,0 +1,200 @@
+#include "raii.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class fd_cache;
+
+/// The deleter of a lease: instead of closing, hand the descriptor back.
+/// Same trick as fd_closer, `pointer` is a file_descriptor.
+struct fd_returner {
+    using pointer = file_descriptor;
+    fd_cache* cache{};
+    void operator()(pointer fd) const noexcept;
+};
+
+using fd_lease = std::unique_ptr<unix_file, fd_returner>;
+
+/// Keeps up to `max_open` descriptors open, closing the least recently
+/// used idle one to make room. Leases of the same path share one
+/// descriptor, so use pread/pwrite rather than the file offset.
+class fd_cache {
+    struct entry {
+        std::string path;
+        unique_fd fd;
+        unsigned leases{};
+        bool stale{}; // invalidated while leased
+    };
+    using list = std::list<entry>;
+
+    mutable std::mutex mtx_;
+    int flags_;
+    std::size_t max_open_;
+    list idle_; // most recently used at the front
+    list busy_;
+    std::unordered_map<std::string, list::iterator> by_path_;
+    std::unordered_map<int, list::iterator> by_fd_;
+    std::size_t opens_{};
+
+    void evict_one() {
+        auto it = std::prev(idle_.end());
+        by_path_.erase(it->path);
+        by_fd_.erase(int(it->fd.get()));
+        idle_.erase(it); // closes
+    }
+
+    friend struct fd_returner;
+
+    void release(int fd) noexcept {
+        std::lock_guard lk{mtx_};
+        auto it = by_fd_.at(fd);
+        if (--it->leases != 0) {
+            return;
+        }
+        if (it->stale) {
+            by_fd_.erase(fd);
+            busy_.erase(it);
+        } else {
+            idle_.splice(idle_.begin(), busy_, it);
+        }
+    }
+
+public:
+    explicit fd_cache(std::size_t max_open, int flags = O_RDONLY)
+        : flags_(flags), max_open_(max_open) {
+    }
+
+    // Outstanding leases point back to us
+    fd_cache(const fd_cache&) = delete;
+    fd_cache& operator=(const fd_cache&) = delete;
+
+    /// Returns an empty lease on failure, with errno set.
+    /// EMFILE means every cached descriptor is currently leased.
+    [[nodiscard]] fd_lease acquire(const std::string& path) {
+        std::lock_guard lk{mtx_};
+        if (auto found = by_path_.find(path); found != by_path_.end()) {
+            auto it = found->second;
+            if (it->leases++ == 0) {
+                busy_.splice(busy_.begin(), idle_, it);
+            }
+            return fd_lease{it->fd.get(), fd_returner{this}};
+        }
+
+        if (idle_.size() + busy_.size() >= max_open_) {
+            if (idle_.empty()) {
+                errno = EMFILE;
+                return fd_lease{nullptr, fd_returner{this}};
+            }
+            evict_one();
+        }
+        auto fd = open_fd(path.c_str(), flags_);
+        if (!fd) {
+            return fd_lease{nullptr, fd_returner{this}};
+        }
+        ++opens_;
+        busy_.push_front({path, std::move(fd), 1, false});
+        auto it = busy_.begin();
+        by_path_.emplace(path, it);
+        by_fd_.emplace(int(it->fd.get()), it);
+        return fd_lease{it->fd.get(), fd_returner{this}};
+    }
+
+    /// Forget a path, e.g. after it was renamed or deleted.
+    /// If it is leased, the descriptor is closed when the last lease returns.
+    void invalidate(const std::string& path) {
+        std::lock_guard lk{mtx_};
+        auto found = by_path_.find(path);
+        if (found == by_path_.end()) {
+            return;
+        }
+        auto it = found->second;
+        by_path_.erase(found);
+        if (it->leases == 0) {
+            by_fd_.erase(int(it->fd.get()));
+            idle_.erase(it);
+        } else {
+            it->stale = true;
+        }
+    }
+
+    std::size_t opens() const {
+        std::lock_guard lk{mtx_};
+        return opens_;
+    }
+    std::size_t size() const {
+        std::lock_guard lk{mtx_};
+        return idle_.size() + busy_.size();
+    }
+};
+
+inline void fd_returner::operator()(pointer fd) const noexcept {
+    cache->release(int(fd));
+}
+
+int main() {
+    constexpr int files = 200;
+    std::vector<std::string> paths;
+    for (int i = 0; i < files; ++i) {
+        paths.push_back("fd_cache_test_" + std::to_string(i) + ".txt");
+        file_ptr fp{std::fopen(paths.back().c_str(), "w")};
+        std::fprintf(fp.get(), "%d\n", i);
+    }
+
+    // Skewed access: most reads hit a few hot files
+    std::mt19937 gen{42};
+    std::geometric_distribution<int> pick{0.02};
+    std::vector<int> accesses(1'000'000);
+    for (auto& a : accesses) {
+        a = pick(gen) % files;
+    }
+
+    auto time = [&](auto read_one) {
+        long sum = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (int a : accesses) {
+            sum += read_one(paths[a]);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        std::cout << std::chrono::duration<double, std::milli>(t1 - t0).count()
+                  << " ms, sum " << sum << '\n';
+    };
+
+    auto read_int = [](int fd) {
+        char buf[16]{};
+        ::pread(fd, buf, sizeof(buf) - 1, 0);
+        return std::atol(buf);
+    };
+
+    std::cout << "open/close: ";
+    time([&](const std::string& path) {
+        auto fd = open_fd(path.c_str(), O_RDONLY);
+        return read_int(int(fd.get()));
+    });
+
+    fd_cache cache{128};
+    std::cout << "fd_cache:   ";
+    time([&](const std::string& path) {
+        auto fd = cache.acquire(path);
+        return read_int(int(fd.get()));
+    });
+    std::cout << cache.opens() << " opens for " << accesses.size()
+              << " accesses, " << cache.size() << " open now\n";
+
+    {
+        auto a = cache.acquire(paths[0]);
+        auto b = cache.acquire(paths[0]); // same descriptor, two leases
+        std::cout << (a.get() == b.get() ? "shared" : "NOT SHARED") << '\n';
+        cache.invalidate(paths[0]);
+    } // closed here, by the last lease
+
+    for (auto& p : paths) {
+        std::remove(p.c_str());
+    }
+}
@@ -0,0 +1,96 @@
+#include "fn.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <random>
+#include <ranges>
+#include <vector>
+
+// std::ranges::fold_left is C++23 and not in libstdc++ 12; this is its
+// specification, minus the return-type conversion details
+template <std::ranges::input_range R, class T, class F>
+constexpr auto fold_left(R&& r, T init, F f) {
+    using U = std::decay_t<std::invoke_result_t<F&, T, std::ranges::range_reference_t<R>>>;
+    U acc = std::move(init);
+    for (auto&& x : r) {
+        acc = std::invoke(f, std::move(acc), std::forward<decltype(x)>(x));
+    }
+    return acc;
+}
+
+static_assert(fn::min(3, 2) == 2);
+static_assert(fn::max({3, 9, 2}) == 9);
+static_assert(fn::clamp(12, 0, 10) == 10);
+static_assert(fn::abs(-3) == 3 && fn::abs(3u) == 3u && fn::abs(-0.5) == 0.5);
+static_assert(fold_left(std::initializer_list<int>{4, -1, 7}, INT_MAX, fn::min) == -1);
+static_assert(std::is_nothrow_invocable_v<decltype(fn::min), int, int>);
+static_assert(!std::is_invocable_v<decltype(fn::min), int, long>); // as std::min
+static_assert(!std::is_nothrow_invocable_v<decltype(fn::to_string), int>);
+static_assert(std::is_empty_v<fn::min_fn>);
+
+// Stable: the first of equivalent elements, as std::min and std::max
+struct item {
+    int key, id;
+    friend constexpr bool operator<(item a, item b) {
+        return a.key < b.key;
+    }
+};
+static_assert(fn::min(item{1, 0}, item{1, 1}).id == 0);
+static_assert(fn::max(item{1, 0}, item{1, 1}).id == 0);
+
+// These compile to the same loop. To check:
+//   g++ -std=c++20 -O3 -mavx2 -S fn.cpp -o - | c++filt | grep -c vpminsd
+// gives 44 with GCC 12: 11 in each of the four (6 pminsd each with -msse4.1).
+// At -O2 GCC 12's cheap vectorizer cost model leaves them all scalar (cmov).
+[[gnu::noinline]] int min_raw(const std::vector<int>& v) {
+    int m = INT_MAX;
+    for (int x : v) {
+        m = x < m ? x : m;
+    }
+    return m;
+}
+
+[[gnu::noinline]] int min_fn_fold(const std::vector<int>& v) {
+    return fold_left(v, INT_MAX, fn::min);
+}
+
+[[gnu::noinline]] int min_lambda_fold(const std::vector<int>& v) {
+    return fold_left(v, INT_MAX, [](int a, int b) { return std::min(a, b); });
+}
+
+[[gnu::noinline]] int min_ranges(const std::vector<int>& v) {
+    return std::min(INT_MAX, std::ranges::min(v));
+}
+
+template <class F>
+void bench(const char* name, const std::vector<int>& v, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    long long r = 0; // ten mins near INT_MIN overflow an int
+    for (int rep = 0; rep < 10; ++rep) {
+        r += f(v);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << name << ": "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() / 10
+              << " ms (" << r / 10 << ")\n";
+}
+
+int main() {
+    std::mt19937 gen{67};
+    std::vector<int> v(50'000'000);
+    for (auto& x : v) {
+        x = int(gen());
+    }
+    bench("raw loop                ", v, min_raw);
+    bench("fold_left(fn::min)      ", v, min_fn_fold);
+    bench("fold_left(lambda)       ", v, min_lambda_fold);
+    bench("std::ranges::min        ", v, min_ranges);
+
+    std::vector<int> numbers{1, 1, 2, 3, 5};
+    for (auto&& s : numbers | std::views::transform(fn::to_string)) {
+        std::cout << s << ' ';
+    }
+    std::cout << '\n';
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+// Function objects for the standard overload sets that can't be passed
+// to algorithms by name ("A Type for Overload Set"):
+//
+//   fold_left(v, INT_MAX, fn::min)
+//   v | std::views::transform(fn::to_string)
+//
+// Each is a constexpr object of a stateless type (so not found by ADL,
+// and free to copy), with noexcept and constraints that follow the
+// operation, and an always_inline call operator: the wrapper must not
+// be what stops a loop from vectorizing.
+
+#include <concepts>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <type_traits>
+
+namespace fn {
+
+namespace detail {
+
+template <class T, class Comp>
+concept compares = std::is_invocable_r_v<bool, Comp&, const T&, const T&>;
+
+template <class T, class Comp>
+inline constexpr bool nothrow_compares =
+    std::is_nothrow_invocable_v<Comp&, const T&, const T&>;
+
+} // namespace detail
+
+struct min_fn {
+    /// Same result as std::min: the first one if they're equivalent
+    template <class T, class Comp = std::less<>>
+        requires detail::compares<T, Comp>
+    [[gnu::always_inline]] constexpr const T& operator()(const T& a, const T& b,
+                                                         Comp comp = {}) const
+        noexcept(detail::nothrow_compares<T, Comp>) {
+        return comp(b, a) ? b : a;
+    }
+
+    template <class T, class Comp = std::less<>>
+        requires detail::compares<T, Comp>
+    [[gnu::always_inline]] constexpr T operator()(std::initializer_list<T> il,
+                                                  Comp comp = {}) const {
+        const T* m = il.begin();
+        for (const T* p = m + 1; p < il.end(); ++p) {
+            m = comp(*p, *m) ? p : m;
+        }
+        return *m;
+    }
+};
+
+struct max_fn {
+    /// Same result as std::max: the first one if they're equivalent
+    template <class T, class Comp = std::less<>>
+        requires detail::compares<T, Comp>
+    [[gnu::always_inline]] constexpr const T& operator()(const T& a, const T& b,
+                                                         Comp comp = {}) const
+        noexcept(detail::nothrow_compares<T, Comp>) {
+        return comp(a, b) ? b : a;
+    }
+
+    template <class T, class Comp = std::less<>>
+        requires detail::compares<T, Comp>
+    [[gnu::always_inline]] constexpr T operator()(std::initializer_list<T> il,
+                                                  Comp comp = {}) const {
+        const T* m = il.begin();
+        for (const T* p = m + 1; p < il.end(); ++p) {
+            m = comp(*m, *p) ? p : m;
+        }
+        return *m;
+    }
+};
+
+struct clamp_fn {
+    template <class T, class Comp = std::less<>>
+        requires detail::compares<T, Comp>
+    [[gnu::always_inline]] constexpr const T& operator()(const T& v, const T& lo,
+                                                         const T& hi,
+                                                         Comp comp = {}) const
+        noexcept(detail::nothrow_compares<T, Comp>) {
+        return comp(v, lo) ? lo : comp(hi, v) ? hi : v;
+    }
+};
+
+struct abs_fn {
+    /// Like std::abs, also for unsigned types (identity); abs of the most
+    /// negative value is undefined, as with std::abs
+    template <class T>
+        requires std::is_arithmetic_v<T>
+    [[gnu::always_inline]] constexpr T operator()(T x) const noexcept {
+        if constexpr (std::is_same_v<T, float>) {
+            return __builtin_fabsf(x); // clears the sign of -0.0 and NaN too
+        } else if constexpr (std::is_same_v<T, double>) {
+            return __builtin_fabs(x);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return __builtin_fabsl(x);
+        } else if constexpr (std::is_unsigned_v<T>) {
+            return x;
+        } else {
+            return x < 0 ? T(-x) : x;
+        }
+    }
+};
+
+struct to_string_fn {
+    /// std::to_string; allocates, so not noexcept
+    template <class T>
+        requires requires(T x) { std::to_string(x); }
+    [[gnu::always_inline]] std::string operator()(T x) const {
+        return std::to_string(x);
+    }
+};
+
+inline constexpr min_fn min{};
+inline constexpr max_fn max{};
+inline constexpr clamp_fn clamp{};
+inline constexpr abs_fn abs{};
+inline constexpr to_string_fn to_string{};
+
+} // namespace fn
@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+// A fold is its own state:
+//   f(x)          consume one element
+//   f.merge(g)    absorb the state of a fold that saw the elements after ours
+//   f.result()    the answer
+// `merge` is what makes a fold parallelizable.
+
+namespace folds {
+
+struct count {
+    std::size_t n = 0;
+    void operator()(double) noexcept {
+        ++n;
+    }
+    void merge(const count& o) noexcept {
+        n += o.n;
+    }
+    std::size_t result() const noexcept {
+        return n;
+    }
+};
+
+struct sum {
+    double s = 0;
+    void operator()(double x) noexcept {
+        s += x;
+    }
+    void merge(const sum& o) noexcept {
+        s += o.s;
+    }
+    double result() const noexcept {
+        return s;
+    }
+};
+
+struct min {
+    double m = std::numeric_limits<double>::infinity();
+    void operator()(double x) noexcept {
+        m = x < m ? x : m;
+    }
+    void merge(const min& o) noexcept {
+        (*this)(o.m);
+    }
+    double result() const noexcept {
+        return m;
+    }
+};
+
+struct max {
+    double m = -std::numeric_limits<double>::infinity();
+    void operator()(double x) noexcept {
+        m = x > m ? x : m;
+    }
+    void merge(const max& o) noexcept {
+        (*this)(o.m);
+    }
+    double result() const noexcept {
+        return m;
+    }
+};
+
+/// Welford's online algorithm; merging is Chan et al.'s parallel variant.
+/// Unlike sum(x^2)/n - mean^2, it does not cancel catastrophically.
+struct variance {
+    std::size_t n = 0;
+    double mean = 0;
+    double m2 = 0; // sum of squared distances from the mean
+    bool sample = false; // divide by n - 1 instead of n
+
+    void operator()(double x) noexcept {
+        ++n;
+        double d = x - mean;
+        mean += d / double(n);
+        m2 += d * (x - mean);
+    }
+    void merge(const variance& o) noexcept {
+        if (o.n == 0) {
+            return;
+        }
+        auto total = n + o.n;
+        double d = o.mean - mean;
+        mean += d * double(o.n) / double(total);
+        m2 += o.m2 + d * d * double(n) * double(o.n) / double(total);
+        n = total;
+    }
+    double result() const noexcept {
+        if (n <= std::size_t(sample)) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+        return m2 / double(sample ? n - 1 : n);
+    }
+};
+
+/// Running mean; no big sum to lose precision in
+struct mean {
+    std::size_t n = 0;
+    double m = 0;
+    void operator()(double x) noexcept {
+        ++n;
+        m += (x - m) / double(n);
+    }
+    void merge(const mean& o) noexcept {
+        if (o.n == 0) {
+            return;
+        }
+        n += o.n;
+        m += (o.m - m) * double(o.n) / double(n);
+    }
+    double result() const noexcept {
+        return n == 0 ? std::numeric_limits<double>::quiet_NaN() : m;
+    }
+};
+
+} // namespace folds
+
+namespace detail {
+
+template <std::ranges::input_range R, class... F>
+std::tuple<F...> run_folds(R&& r, std::tuple<F...> fs) {
+    // One loop; each element goes through every fold while it's in a register
+    std::apply(
+        [&](F&... f) {
+            for (auto&& x : r) {
+                (f(x), ...);
+            }
+        },
+        fs);
+    return fs;
+}
+
+template <class... F>
+auto results(const std::tuple<F...>& fs) {
+    return std::apply([](const F&... f) { return std::tuple{f.result()...}; }, fs);
+}
+
+} // namespace detail
+
+/// Run all `folds` over `r` in a single pass.
+/// Returns a tuple of their results, in order.
+template <std::ranges::input_range R, class... F>
+auto fold_many(R&& r, F... folds) {
+    return detail::results(detail::run_folds(r, std::tuple{folds...}));
+}
+
+/// Same, with the input split across `threads`.
+/// Each thread folds one contiguous piece into a copy of `folds`,
+/// and the pieces are merged left to right.
+template <std::ranges::random_access_range R, class... F>
+    requires std::ranges::sized_range<R>
+auto fold_many(unsigned threads, R&& r, F... folds) {
+    threads = std::max(threads, 1u);
+    auto n = std::ranges::size(r);
+    std::vector<std::tuple<F...>> parts(threads, std::tuple{folds...});
+    {
+        std::vector<std::jthread> pool;
+        for (unsigned t = 0; t < threads; ++t) {
+            auto piece = std::ranges::subrange(std::ranges::begin(r) + n * t / threads,
+                                               std::ranges::begin(r) + n * (t + 1) / threads);
+            pool.emplace_back([&parts, piece, t] {
+                parts[t] = detail::run_folds(piece, std::move(parts[t]));
+            });
+        }
+    }
+    for (unsigned t = 1; t < threads; ++t) {
+        std::apply(
+            [&](F&... into) {
+                std::apply([&](const F&... from) { (into.merge(from), ...); }, parts[t]);
+            },
+            parts[0]);
+    }
+    return detail::results(parts[0]);
+}
+
+int main() {
+    std::mt19937_64 gen{59};
+    std::normal_distribution<double> dist{1e6, 3}; // big mean, small spread
+    std::vector<double> column(50'000'000);
+    for (auto& x : column) {
+        x = dist(gen);
+    }
+
+    using ms = std::chrono::duration<double, std::milli>;
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto n = column.size();
+    auto s = std::accumulate(column.begin(), column.end(), 0.0);
+    auto lo = *std::min_element(column.begin(), column.end());
+    auto hi = *std::max_element(column.begin(), column.end());
+    auto m = std::accumulate(column.begin(), column.end(), 0.0) / double(n);
+    auto sq = std::accumulate(column.begin(), column.end(), 0.0,
+                              [](double a, double x) { return a + x * x; });
+    auto v_naive = sq / double(n) - m * m;
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << "separate passes: " << ms(t1 - t0).count() << " ms\n"
+              << "  n " << n << ", sum " << s << ", min " << lo << ", max " << hi
+              << ", mean " << m << ", variance " << v_naive << " (cancelled)\n";
+
+    auto t2 = std::chrono::steady_clock::now();
+    auto [n1, s1, lo1, hi1, m1, v1] =
+        fold_many(column, folds::count{}, folds::sum{}, folds::min{},
+                  folds::max{}, folds::mean{}, folds::variance{});
+    auto t3 = std::chrono::steady_clock::now();
+    std::cout << "fold_many:       " << ms(t3 - t2).count() << " ms\n"
+              << "  n " << n1 << ", sum " << s1 << ", min " << lo1 << ", max "
+              << hi1 << ", mean " << m1 << ", variance " << v1 << '\n';
+
+    auto t4 = std::chrono::steady_clock::now();
+    auto [n2, s2, lo2, hi2, m2, v2] =
+        fold_many(4, column, folds::count{}, folds::sum{}, folds::min{},
+                  folds::max{}, folds::mean{}, folds::variance{});
+    auto t5 = std::chrono::steady_clock::now();
+    std::cout << "fold_many x4:    " << ms(t5 - t4).count() << " ms\n"
+              << "  n " << n2 << ", sum " << s2 << ", min " << lo2 << ", max "
+              << hi2 << ", mean " << m2 << ", variance " << v2 << '\n';
+
+    // Nothing to fold: no mean, and no variance of either kind
+    std::vector<double> none;
+    auto [m0, v0, sv0] = fold_many(none, folds::mean{}, folds::variance{},
+                                   folds::variance{.sample = true});
+    auto [sv1] = fold_many(std::vector{1.0}, folds::variance{.sample = true});
+    if (!std::isnan(m0) || !std::isnan(v0) || !std::isnan(sv0) || !std::isnan(sv1)) {
+        std::cout << "FAILED: empty fold\n";
+        return 1;
+    }
+}
@@ -0,0 +1,113 @@
+#include "aggregate_format.hpp"
+
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <iterator>
+#include <string>
+
+struct Point {
+    int x, y;
+};
+
+/// The same fields, formatted as in the post
+struct PostPoint {
+    int x, y;
+};
+
+struct Vec3 {
+    double x, y, z;
+};
+
+/// Mixed types: each field is formatted as its own type
+struct Fill {
+    std::int64_t qty;
+    std::uint64_t id;
+    char venue;
+};
+
+/// Wider character types are numbers too
+struct Glyph {
+    wchar_t w;
+    char16_t u16;
+    char32_t u32;
+    char8_t u8;
+};
+
+template <>
+struct fmt_lib::formatter<Point> : aggregate_formatter<Point> {};
+
+template <>
+struct fmt_lib::formatter<Vec3> : aggregate_formatter<Vec3> {};
+
+template <>
+struct fmt_lib::formatter<Fill> : aggregate_formatter<Fill> {};
+
+template <>
+struct fmt_lib::formatter<Glyph> : aggregate_formatter<Glyph> {};
+
+template <>
+struct fmt_lib::formatter<PostPoint> {
+    constexpr auto parse(auto& ctx) {
+        return ctx.begin();
+    }
+    auto format(const PostPoint& p, auto& ctx) const {
+        return fmt_lib::format_to(ctx.out(), "Point({}, {})", p.x, p.y);
+    }
+};
+
+template <class F>
+void bench(const char* name, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    println(STDERR_FILENO, "{}: {:.1f} ms", name,
+            std::chrono::duration<double, std::milli>(t1 - t0).count());
+}
+
+template <class P>
+std::string format_all(int n) {
+    std::string out;
+    out.reserve(std::size_t(n) * 24);
+    for (int i = 0; i < n; ++i) {
+        fmt_lib::format_to(std::back_inserter(out), "{}\n", P{i, -i * 7});
+    }
+    return out;
+}
+
+int main() {
+    static_assert(type_name<Point>() == "Point");
+    static_assert(aggregate_formatter<Point>::max_chars == 31);
+
+    bool ok = true;
+    auto check = [&](std::string_view got, std::string_view want) {
+        if (got != want) {
+            println(STDERR_FILENO, "got {}, want {}", got, want);
+            ok = false;
+        }
+    };
+    check(fmt_lib::format("{}", Point{1, -2}), "Point(1, -2)");
+    check(fmt_lib::format("{:+}", Point{1, 2}), "Point(+1, +2)");
+    check(fmt_lib::format("{:#x}", Point{255, 16}), "Point(0xff, 0x10)");
+    check(fmt_lib::format("{:>4}", Point{1, 22}), "Point(   1,   22)");
+    check(fmt_lib::format("{}", Vec3{0.5, -1, 1e300}), "Vec3(0.5, -1, 1e+300)");
+    check(fmt_lib::format("{:.2f}", Vec3{0.5, -1, 2}), "Vec3(0.50, -1.00, 2.00)");
+    check(fmt_lib::format("{}", Point{INT_MIN, INT_MAX}),
+          "Point(-2147483648, 2147483647)");
+    check(fmt_lib::format("{}", Fill{-5, UINT64_MAX, 'A'}),
+          "Fill(-5, 18446744073709551615, 65)");
+    check(fmt_lib::format("{:>3}", Fill{-5, 7, 'A'}), "Fill( -5,   7,  65)");
+    check(fmt_lib::format("{}", Glyph{L'A', u'\u00e9', U'\U0001f600', u8'z'}),
+          "Glyph(65, 233, 128512, 122)");
+    // fmt_lib::format("{:s}", Point{}); // error at compile time: bad spec for int
+
+    // 10M Points into one string
+    constexpr int n = 10'000'000;
+    std::string a, b;
+    bench("format_to(\"Point({}, {})\")", [&] { a = format_all<PostPoint>(n); });
+    bench("aggregate_formatter        ", [&] { b = format_all<Point>(n); });
+    check(a.substr(0, 64), b.substr(0, 64));
+    ok = ok && a == b;
+    println(STDERR_FILENO, "same text: {}", a == b);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,224 @@
+#include "raii.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <span>
+#include <string>
+
+#include <sys/stat.h>
+
+enum class huge_pages {
+    none,
+    transparent, // madvise(MADV_HUGEPAGE); best effort
+    explicit_,   // MAP_HUGETLB; needs a hugetlbfs file or reserved pages
+};
+
+enum class access_pattern {
+    normal,
+    sequential, // MADV_SEQUENTIAL: aggressive read-ahead, drop behind
+    random,     // MADV_RANDOM: no read-ahead
+};
+
+struct map_options {
+    bool writable = false;
+    bool populate = false; // MAP_POPULATE: take all page faults up front
+    bool will_need = false; // MADV_WILLNEED: start read-ahead, don't wait
+    bool lock = false;      // mlock: keep it resident
+    huge_pages huge = huge_pages::none;
+    access_pattern access = access_pattern::normal;
+};
+
+/// An owning, span-like view of a mapped file
+template <class T = const std::byte>
+class mapped_file {
+    mapped_mem_ptr mem_;
+    std::size_t size_{}; // in bytes; the mapping itself may be larger
+
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+
+    mapped_file() = default;
+    mapped_file(mapped_mem_ptr mem, std::size_t size) noexcept
+        : mem_(std::move(mem)), size_(size) {
+    }
+
+    T* data() const noexcept {
+        return static_cast<T*>(mem_.get());
+    }
+    std::size_t size() const noexcept {
+        return size_ / sizeof(T);
+    }
+    std::size_t size_bytes() const noexcept {
+        return size_;
+    }
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+    T* begin() const noexcept {
+        return data();
+    }
+    T* end() const noexcept {
+        return data() + size();
+    }
+    T& operator[](std::size_t i) const noexcept {
+        return data()[i];
+    }
+    explicit operator bool() const noexcept {
+        return bool(mem_);
+    }
+
+    operator std::span<T>() const noexcept {
+        return {data(), size()};
+    }
+};
+
+inline constexpr std::size_t huge_page_size = 2 << 20;
+
+/// Map a whole file. Returns an empty (falsy) view on failure, with errno set;
+/// an empty file can't be mapped (EINVAL, as from mmap).
+/// Huge pages and access advice are hints: if the kernel refuses them,
+/// we still hand out a normal mapping. A requested `lock` is not a hint.
+template <class T = const std::byte>
+[[nodiscard]] mapped_file<T> map_file(const char* path,
+                                      const map_options& opts = {}) {
+    auto fd = open_fd(path, opts.writable ? O_RDWR : O_RDONLY);
+    if (!fd) {
+        return {};
+    }
+    struct stat st;
+    if (::fstat(int(fd.get()), &st) != 0) {
+        return {};
+    }
+    if (st.st_size == 0) {
+        errno = EINVAL;
+        return {};
+    }
+    auto size = static_cast<std::size_t>(st.st_size);
+
+    int prot = opts.writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    int flags = MAP_SHARED;
+    if (opts.populate) {
+        flags |= MAP_POPULATE;
+    }
+
+    mapped_mem_ptr mem;
+    if (opts.huge == huge_pages::explicit_) {
+        std::size_t length = (size + huge_page_size - 1) / huge_page_size * huge_page_size;
+        mem = make_mapped_mem(nullptr, length, prot, flags | MAP_HUGETLB,
+                              int(fd.get()), 0);
+    }
+    if (!mem) {
+        mem = make_mapped_mem(nullptr, size, prot, flags, int(fd.get()), 0);
+        if (!mem) {
+            return {};
+        }
+    }
+    // The mapping keeps the file alive; fd closes here
+
+    std::size_t length = mem.get_deleter().length;
+    if (opts.huge == huge_pages::transparent) {
+        ::madvise(mem.get(), length, MADV_HUGEPAGE);
+    }
+    switch (opts.access) {
+    case access_pattern::normal:
+        break;
+    case access_pattern::sequential:
+        ::madvise(mem.get(), length, MADV_SEQUENTIAL);
+        break;
+    case access_pattern::random:
+        ::madvise(mem.get(), length, MADV_RANDOM);
+        break;
+    }
+    if (opts.will_need) {
+        ::madvise(mem.get(), length, MADV_WILLNEED);
+    }
+    if (opts.lock && ::mlock(mem.get(), length) != 0) {
+        int err = errno;
+        mem.reset();
+        errno = err; // munmap may clobber it
+        return {};
+    }
+    // munmap drops the lock along with the mapping
+
+    return {std::move(mem), size};
+}
+
+template <class Span>
+void scan(const Span& view, std::uint64_t& sum) {
+    // Touch one byte per page: this is all page faults and TLB misses
+    for (std::size_t i = 0; i < view.size(); i += 4096) {
+        sum += std::to_integer<unsigned>(view[i]);
+    }
+}
+
+/// Drop the file's pages from the page cache (it is clean: no root needed)
+bool evict(const char* path) {
+    auto fd = open_fd(path, O_RDONLY);
+    return fd && ::posix_fadvise(int(fd.get()), 0, 0, POSIX_FADV_DONTNEED) == 0;
+}
+
+/// map_file and the scan together: MAP_POPULATE pays inside map_file,
+/// fault-in during the scan. Cold from disk, then warm from the page cache.
+void bench(const char* name, const char* path, const map_options& opts,
+           std::uint64_t& sum) {
+    for (bool cold : {true, false}) {
+        if (cold && !evict(path)) {
+            std::cout << name << "cold: " << std::strerror(errno) << '\n';
+            continue;
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        auto view = map_file(path, opts);
+        if (!view) {
+            std::cout << name << std::strerror(errno)
+                      << (opts.lock ? " (see RLIMIT_MEMLOCK)\n" : "\n");
+            return;
+        }
+        scan(view, sum);
+        auto t1 = std::chrono::steady_clock::now();
+        std::cout << name << (cold ? "cold " : "warm ")
+                  << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "map_file_test.bin";
+    if (argc <= 1) {
+        file_ptr fp{std::fopen(path.c_str(), "wb")};
+        std::string block(1 << 20, 'x');
+        for (int i = 0; i < 256; ++i) {
+            block[0] = char(i);
+            std::fwrite(block.data(), 1, block.size(), fp.get());
+        }
+        std::fflush(fp.get());
+        ::fsync(::fileno(fp.get())); // dirty pages can't be evicted
+    }
+
+    std::uint64_t sum = 0;
+    if (!map_file(path.c_str())) {
+        std::cerr << path << ": " << std::strerror(errno) << '\n';
+        return 1;
+    }
+    bench("default:          ", path.c_str(), {}, sum);
+    bench("populate:         ", path.c_str(), {.populate = true}, sum);
+    bench("populate+THP+seq: ", path.c_str(),
+          {.populate = true, .huge = huge_pages::transparent,
+           .access = access_pattern::sequential},
+          sum);
+    bench("mlock:            ", path.c_str(), {.lock = true}, sum);
+
+    auto view = map_file(path.c_str());
+    std::span<const std::byte> s = view; // non-owning; `view` must outlive it
+    std::cout << "checksum " << sum << ", " << s.size() << " bytes\n";
+
+    if (argc <= 1) {
+        std::remove(path.c_str());
+        file_ptr{std::fopen(path.c_str(), "wb")}; // empty
+        bool refused = !map_file(path.c_str()) && errno == EINVAL;
+        std::cout << "empty file: " << (refused ? "EINVAL" : "WRONG") << '\n';
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,104 @@
+#include "overload.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <vector>
+
+void f(int) noexcept {
+}
+int f(int, int) {
+    return 0;
+}
+
+struct Bar {
+    int n = 0;
+    int foo(int x) noexcept {
+        return n += x;
+    }
+    int foo(int x) const noexcept {
+        return n + x;
+    }
+    template <class T>
+    T bar(T t) const {
+        return t;
+    }
+    int baz(int a, int b = 10) const {
+        return a + b;
+    }
+    virtual int who() const {
+        return 0;
+    }
+    virtual ~Bar() = default;
+};
+
+struct Derived : Bar {
+    int who() const override {
+        return 1;
+    }
+};
+
+// noexcept follows the overload that gets picked
+static_assert(std::is_nothrow_invocable_v<decltype(OVERLOAD(f)), int>);
+static_assert(!std::is_nothrow_invocable_v<decltype(OVERLOAD(f)), int, int>);
+// and arguments nothing accepts are a substitution failure, not an error
+static_assert(!std::is_invocable_v<decltype(OVERLOAD(f)), std::string>);
+static_assert(std::is_same_v<std::invoke_result_t<decltype(OVERLOAD(f)), int, int>, int>);
+
+using foo_t = decltype(OVERLOAD_MF(foo));
+static_assert(std::is_nothrow_invocable_v<foo_t, Bar&, int>);
+static_assert(std::is_nothrow_invocable_v<foo_t, const Bar*, int>);
+static_assert(std::is_nothrow_invocable_v<foo_t, std::unique_ptr<Bar>&, int>);
+static_assert(std::is_nothrow_invocable_v<foo_t, std::reference_wrapper<const Bar>, int>);
+static_assert(!std::is_invocable_v<foo_t, Bar&, std::string>);
+static_assert(!std::is_invocable_v<foo_t, int, int>);
+
+// Moving a vector of these is noexcept only if the element's move is,
+// which is what vector growth and std::move_if_noexcept look at
+struct holder {
+    decltype(OVERLOAD(f)) fn;
+};
+static_assert(std::is_nothrow_move_constructible_v<holder>);
+
+int main() {
+    std::vector<int> numbers{1, 1, 2, 3, 5};
+
+    // The post's examples
+    for (auto&& s : numbers | std::views::transform(OVERLOAD(std::to_string))) {
+        std::cout << s << ' ';
+    }
+    std::cout << '\n';
+
+    auto min_v = std::accumulate(numbers.begin(), numbers.end(), INT_MAX, OVERLOAD(std::min));
+    std::cout << "min: " << min_v << '\n';
+
+    Bar bar;
+    const Bar& cbar = bar;
+    auto foo = OVERLOAD_MF(foo);
+    std::cout << "foo: " << std::invoke(foo, bar, 42) << ' '   // non-const: n = 42
+              << std::invoke(foo, cbar, 1) << ' '              // const: 43
+              << std::bind_front(foo, &bar)(1) << '\n';        // pointer: n = 43
+
+    // Templated and defaulted members
+    std::cout << "bar: " << OVERLOAD_MF(bar)(bar, 2.5) << ", baz: "
+              << OVERLOAD_MF(baz)(bar, 1) << ' ' << OVERLOAD_MF(baz)(bar, 1, 2) << '\n';
+
+    // Bare name: virtual; qualified name: not
+    auto d = std::make_unique<Derived>();
+    std::cout << "who: " << OVERLOAD_MF(who)(d) << ' '
+              << OVERLOAD_MF(Bar::who)(*d) << '\n';
+
+    // optional<Bar> has no foo, so it is dereferenced
+    std::optional<Bar> ob{std::in_place};
+    std::cout << "optional: " << OVERLOAD_MF(foo)(ob, 7) << '\n';
+
+    // An optional of something with a member named value is called directly:
+    // first match wins, so the object's own member comes before operator*
+    std::optional<int> oi{3};
+    std::cout << "value: " << OVERLOAD_MF(value)(oi) << '\n';
+}
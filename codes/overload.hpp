@@ -0,0 +1,167 @@
+#pragma once
+
+// Production versions of the macros from "A Type for Overload Set".
+//
+// Compared with the post:
+// - noexcept is propagated, so std::is_nothrow_invocable and the
+//   nothrow paths of algorithms and containers see through the wrapper;
+// - the return type is decltype(the call), not decltype(auto), so an
+//   argument list the overload set can't take is a substitution failure
+//   (std::is_invocable is false), not a hard error in the lambda body;
+// - OVERLOAD_MF accepts what std::invoke accepts as the object:
+//   a reference, a pointer, a smart pointer or a std::reference_wrapper.
+
+#include <concepts>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#define OVERLOAD_FWD(x) std::forward<decltype(x)>(x)
+
+// `return expr;` with a matching noexcept and return type
+#define OVERLOAD_RETURNS(...)                                                  \
+    noexcept(noexcept(__VA_ARGS__))->decltype(__VA_ARGS__) {                   \
+        return __VA_ARGS__;                                                    \
+    }
+
+/// An object for the overload set `fun`: OVERLOAD(std::to_string)
+#define OVERLOAD(fun)                                                          \
+    [](auto&&... args) OVERLOAD_RETURNS(fun(OVERLOAD_FWD(args)...))
+
+/// An object for the member functions named `fun`: OVERLOAD_MF(foo).
+/// Called as f(self, args...), like std::invoke(&Bar::foo, self, args...).
+/// A qualified name, OVERLOAD_MF(Bar::foo), also works, but a qualified
+/// call is never virtual; pass the bare name to keep virtual dispatch.
+#define OVERLOAD_MF(fun)                                                       \
+    ::overload_detail::first_of{                                               \
+        [](auto&& self, auto&&... args)                                        \
+            OVERLOAD_RETURNS(OVERLOAD_FWD(self).fun(OVERLOAD_FWD(args)...)),   \
+        [](auto&& self, auto&&... args)                                        \
+            OVERLOAD_RETURNS(self.get().fun(OVERLOAD_FWD(args)...)),           \
+        [](auto&& self, auto&&... args)                                        \
+            OVERLOAD_RETURNS((*OVERLOAD_FWD(self)).fun(OVERLOAD_FWD(args)...)), \
+    }
+
+namespace overload_detail {
+
+/// Calls the first of `fs` that is invocable with the arguments.
+/// Ordered, so an object that has both the member and operator*
+/// (std::optional, say) is still called directly.
+template <class... Fs>
+struct first_of;
+
+template <class F>
+struct first_of<F> {
+    [[no_unique_address]] F f;
+
+    template <class... A>
+    constexpr auto operator()(A&&... a) const
+        noexcept(std::is_nothrow_invocable_v<const F&, A...>)
+            -> std::invoke_result_t<const F&, A...> {
+        return f(std::forward<A>(a)...);
+    }
+};
+
+template <class F, class... Rest>
+struct first_of<F, Rest...> {
+    [[no_unique_address]] F f;
+    [[no_unique_address]] first_of<Rest...> rest;
+
+    template <class... A>
+        requires std::invocable<const F&, A...>
+    constexpr auto operator()(A&&... a) const
+        noexcept(std::is_nothrow_invocable_v<const F&, A...>)
+            -> std::invoke_result_t<const F&, A...> {
+        return f(std::forward<A>(a)...);
+    }
+
+    template <class... A>
+        requires(!std::invocable<const F&, A...>)
+    constexpr auto operator()(A&&... a) const
+        noexcept(std::is_nothrow_invocable_v<const first_of<Rest...>&, A...>)
+            -> std::invoke_result_t<const first_of<Rest...>&, A...> {
+        return rest(std::forward<A>(a)...);
+    }
+};
+
+template <class F, class... Rest>
+first_of(F, Rest...) -> first_of<F, Rest...>;
+
+} // namespace overload_detail
+
+// bind_front for members, including overloaded, templated and
+// defaulted ones:
+//
+//   auto f = BIND_MEMBER(bar, foo);   // f(args...) is bar.foo(args...)
+//
+// `bar` is stored as is: a copy of an object, or a pointer, smart
+// pointer or std::ref to share one (any `self` OVERLOAD_MF accepts).
+// The call member is an empty object, so a binder is the size of
+// what it binds, and calls are direct, with the binder's value
+// category passed on to the object, like std::bind_front.
+// Like a lambda, each BIND_MEMBER has a type of its own.
+// For one non-overloaded member, bind_member<&Bar::foo>(bar) also works.
+
+template <class Obj, class F>
+class bound_member {
+    Obj obj_;
+    [[no_unique_address]] F f_;
+
+public:
+    constexpr bound_member(Obj obj, F f) noexcept(std::is_nothrow_move_constructible_v<Obj>)
+        : obj_(std::move(obj)), f_(f) {}
+
+    template <class... A>
+    constexpr auto operator()(A&&... a) & noexcept(
+        std::is_nothrow_invocable_v<const F&, Obj&, A...>)
+        -> std::invoke_result_t<const F&, Obj&, A...> {
+        return f_(obj_, std::forward<A>(a)...);
+    }
+    template <class... A>
+    constexpr auto operator()(A&&... a) const& noexcept(
+        std::is_nothrow_invocable_v<const F&, const Obj&, A...>)
+        -> std::invoke_result_t<const F&, const Obj&, A...> {
+        return f_(obj_, std::forward<A>(a)...);
+    }
+    template <class... A>
+    constexpr auto operator()(A&&... a) && noexcept(
+        std::is_nothrow_invocable_v<const F&, Obj&&, A...>)
+        -> std::invoke_result_t<const F&, Obj&&, A...> {
+        return f_(std::move(obj_), std::forward<A>(a)...);
+    }
+    template <class... A>
+    constexpr auto operator()(A&&... a) const&& noexcept(
+        std::is_nothrow_invocable_v<const F&, const Obj&&, A...>)
+        -> std::invoke_result_t<const F&, const Obj&&, A...> {
+        return f_(std::move(obj_), std::forward<A>(a)...);
+    }
+
+    constexpr const Obj& object() const noexcept {
+        return obj_;
+    }
+};
+
+#define BIND_MEMBER(obj, fun) ::bound_member{(obj), OVERLOAD_MF(fun)}
+
+namespace overload_detail {
+
+template <auto Member>
+struct invoke_member {
+    template <class... A>
+    constexpr auto operator()(A&&... a) const
+        noexcept(std::is_nothrow_invocable_v<decltype(Member), A...>)
+            -> std::invoke_result_t<decltype(Member), A...> {
+        return std::invoke(Member, std::forward<A>(a)...);
+    }
+};
+
+} // namespace overload_detail
+
+/// The member is a template argument, not stored: same size as `obj`
+template <auto Member, class Obj>
+    requires std::is_member_pointer_v<decltype(Member)>
+constexpr auto bind_member(Obj&& obj) noexcept(
+    std::is_nothrow_constructible_v<std::decay_t<Obj>, Obj>) {
+    return bound_member<std::decay_t<Obj>, overload_detail::invoke_member<Member>>{
+        std::forward<Obj>(obj), {}};
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+// receive_packet() from "Structured Bindings in C++26", over a datagram
+// socket (UDP, or AF_UNIX SOCK_DGRAM):
+//
+//   packet_source<wire_header> src{fd};
+//   while (auto [header, body] = src.receive_packet()) {   // C++26
+//       handle(header->seq, body);
+//   }
+//
+// Before P0963 is implemented, bind, then decompose:
+//
+//   while (auto p = src.receive_packet()) {
+//       auto [header, body] = p;
+//
+// One recvmmsg fills a batch of fixed-size buffers, allocated once; the
+// calls in between only hand out the next one: no system call and no
+// allocation per packet. `header` is the first sizeof(Header) bytes seen
+// as a Header (start_lifetime_as, not a copy), `body` the rest.
+// Both point into the source's buffers, reused by the next batch: they
+// are valid until the next call to receive_packet().
+
+#include "raii.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+namespace packet_detail {
+
+#if defined(__cpp_lib_start_lifetime_as)
+using std::start_lifetime_as;
+#else
+/// The library's start_lifetime_as is (in effect) this: memmove
+/// implicitly creates objects in its destination and keeps the bytes
+template <class T>
+    requires std::is_trivially_copyable_v<T>
+T* start_lifetime_as(void* p) noexcept {
+    return std::launder(static_cast<T*>(std::memmove(p, p, sizeof(T))));
+}
+#endif
+
+} // namespace packet_detail
+
+/// A received datagram, or nothing (false) if there was none to take
+template <class Header>
+struct packet {
+    const Header* header = nullptr;
+    std::span<const std::byte> body;
+
+    explicit constexpr operator bool() const noexcept {
+        return header != nullptr;
+    }
+};
+
+struct packet_options {
+    unsigned batch = 64;          // datagrams per recvmmsg
+    std::size_t max_size = 2048;  // larger ones are truncated, and skipped
+    bool wait = true;             // block for the first datagram of a batch
+};
+
+template <class Header>
+    requires std::is_trivially_copyable_v<Header>
+class packet_source {
+public:
+    /// `fd` is not owned, and must outlive the source
+    explicit packet_source(int fd, packet_options opt = {})
+        : fd_(fd),
+          opt_(opt),
+          stride_((opt.max_size + 63) / 64 * 64), // keeps every Header aligned
+          buffers_(make_aligned_bytes(4096, stride_ * opt.batch)),
+          iovs_(opt.batch),
+          msgs_(opt.batch) {
+        static_assert(alignof(Header) <= 64);
+        for (unsigned i = 0; i < opt_.batch; ++i) {
+            iovs_[i] = {buffers_.get() + i * stride_, opt_.max_size};
+            msgs_[i].msg_hdr.msg_iov = &iovs_[i];
+            msgs_[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    packet_source(const packet_source&) = delete;
+    packet_source& operator=(const packet_source&) = delete;
+
+    /// The next datagram; empty when none is ready (wait = false), or on
+    /// an error (see error())
+    packet<Header> receive_packet() {
+        for (;;) {
+            while (next_ < count_) {
+                const mmsghdr& m = msgs_[next_];
+                std::byte* p = buffers_.get() + next_ * stride_;
+                ++next_;
+                if (m.msg_len < sizeof(Header) || (m.msg_hdr.msg_flags & MSG_TRUNC)) {
+                    ++skipped_;
+                    continue;
+                }
+                return {packet_detail::start_lifetime_as<Header>(p),
+                        {p + sizeof(Header), m.msg_len - sizeof(Header)}};
+            }
+            if (!refill()) {
+                return {};
+            }
+        }
+    }
+
+    /// errno of the last failed recvmmsg, or 0
+    int error() const noexcept {
+        return error_;
+    }
+    /// Datagrams shorter than a Header, or longer than max_size
+    std::size_t skipped() const noexcept {
+        return skipped_;
+    }
+    /// recvmmsg calls that returned datagrams
+    std::size_t batches() const noexcept {
+        return batches_;
+    }
+
+private:
+    bool refill() {
+        next_ = count_ = 0;
+        int flags = opt_.wait ? MSG_WAITFORONE : MSG_DONTWAIT;
+        int n;
+        while ((n = ::recvmmsg(fd_, msgs_.data(), opt_.batch, flags, nullptr)) < 0 &&
+               errno == EINTR) {
+        }
+        if (n <= 0) {
+            error_ = n < 0 && errno != EAGAIN && errno != EWOULDBLOCK ? errno : 0;
+            return false;
+        }
+        count_ = unsigned(n);
+        ++batches_;
+        return true;
+    }
+
+    int fd_;
+    packet_options opt_;
+    std::size_t stride_;
+    aligned_bytes_ptr buffers_;
+    std::vector<iovec> iovs_;
+    std::vector<mmsghdr> msgs_;
+    unsigned next_ = 0, count_ = 0;
+    int error_ = 0;
+    std::size_t skipped_ = 0, batches_ = 0;
+};
@@ -0,0 +1,107 @@
+#include "parse_column.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+template <class F>
+void bench(const char* name, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << name << ": "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+}
+
+/// Cells of a two-column CSV, "id,price\n" per row, split in place
+struct table {
+    std::string text;
+    std::vector<std::string_view> ids, prices;
+
+    explicit table(int rows) {
+        std::mt19937_64 rng(1);
+        for (int i = 0; i < rows; ++i) {
+            text += std::to_string(std::int64_t(rng()) >> (rng() % 64));
+            text += ',';
+            text += std::to_string(rng() % 100000);
+            text += '.';
+            text += std::to_string(rng() % 100);
+            text += '\n';
+        }
+        for (std::size_t b = 0; b < text.size();) {
+            std::size_t comma = text.find(',', b), nl = text.find('\n', comma);
+            ids.emplace_back(text.data() + b, comma - b);
+            prices.emplace_back(text.data() + comma + 1, nl - comma - 1);
+            b = nl + 1;
+        }
+    }
+};
+
+int main() {
+    bool ok = true;
+    auto check = [&](bool c, const char* what) {
+        if (!c) {
+            std::cout << "FAILED: " << what << '\n';
+            ok = false;
+        }
+    };
+
+    std::vector<std::string_view> cells{"1", "-22", "333", "123456789012345678901", "5"};
+    std::vector<std::int64_t> v(cells.size());
+    column_error e = parse_column(cells, std::span{v});
+    check(e && e.row == 3 && e.error.ec == std::errc::result_out_of_range, "overflow row");
+    cells[3] = "0000000000000000000000004"; // long, but fine: from_chars takes it
+    check(!parse_column(cells, std::span{v}) && v[3] == 4 && v[1] == -22, "fallback");
+
+    std::vector<double> d(3);
+    std::vector<std::string> dcells{"0.1", "-2.5e3", "1e400"};
+    e = parse_column(dcells, std::span{d});
+    check(e.row == 2 && d[0] == 0.1 && d[1] == -2500, "doubles");
+
+    constexpr int rows = 10'000'000;
+    table t(rows);
+    std::vector<std::int64_t> ids(rows), ids2(rows);
+    std::vector<double> prices(rows), prices2(rows);
+
+    // Bad cells near the end of a threaded parse: the lower row is reported
+    auto bad = t.ids;
+    bad[rows - 10] = "x";
+    bad[rows - 5] = "y";
+    e = parse_column(bad, std::span{ids}, {.threads = 3});
+    check(e.row == rows - 10, "lowest bad row");
+
+    bench("from_chars per cell     ", [&] {
+        for (int i = 0; i < rows; ++i) {
+            auto s = t.ids[i];
+            std::from_chars(s.data(), s.data() + s.size(), ids2[i]);
+            s = t.prices[i];
+            std::from_chars(s.data(), s.data() + s.size(), prices2[i]);
+        }
+    });
+    bench("from_string per cell    ", [&] {
+        for (int i = 0; i < rows; ++i) {
+            if (from_string(t.ids[i], ids[i]) || from_string(t.prices[i], prices[i])) {
+                break;
+            }
+        }
+    });
+    check(ids == ids2 && prices == prices2, "from_string matches from_chars");
+    bench("parse_column per cell   ", [&] {
+        check(!parse_column(t.ids, std::span{ids}) && !parse_column(t.prices, std::span{prices}),
+              "no errors");
+    });
+    check(ids == ids2 && prices == prices2, "parse_column matches from_chars");
+    unsigned hw = std::max(std::thread::hardware_concurrency(), 1u);
+    std::cout << hw << " threads\n";
+    bench("parse_column, threads   ", [&] {
+        parse_column(t.ids, std::span{ids}, {.threads = hw});
+        parse_column(t.prices, std::span{prices}, {.threads = hw});
+    });
+    check(ids == ids2 && prices == prices2, "threaded parse_column matches from_chars");
+    return ok ? 0 : 1;
+}
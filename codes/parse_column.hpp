@@ -0,0 +1,96 @@
+#pragma once
+
+// A whole column of cells into a span:
+//
+//   std::vector<std::int64_t> ids(cells.size());
+//   if (auto e = parse_column(cells, std::span{ids})) {
+//       // cells[e.row] is the first bad one; e.error says why and where
+//   }
+//
+// Each cell goes through string_converter<T>, as from_string would take
+// it; what this adds is the error report (the lowest bad row) and, with
+// threads > 1, one contiguous piece of the column per thread.
+//
+// Cells are parsed one at a time. A batched version (branch-free fast
+// paths, with a per-batch list of rows for the slow path) was measured
+// no faster: on 10M id and price cells, 505-680 ms a run against
+// 515-700 ms for from_string per cell and 520-720 ms for from_chars,
+// on a noisy one-core VM. The cost is per-cell work on cells of random
+// length, and batching doesn't remove it.
+
+#include "string_converter.hpp"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+struct column_options {
+    unsigned threads = 1;
+};
+
+/// No error if `error` is; otherwise the lowest bad row
+struct column_error {
+    std::size_t row = 0;
+    scan_error error;
+
+    explicit constexpr operator bool() const noexcept {
+        return bool(error);
+    }
+};
+
+namespace column_detail {
+
+// Fewer rows than this aren't worth a thread
+inline constexpr std::size_t min_rows_per_thread = 1 << 14;
+
+/// Rows [first, last); stops at the first bad one
+template <class T, class It>
+column_error parse_rows(It cells, std::span<T> out, std::size_t first, std::size_t last) {
+    string_converter<T> conv;
+    for (std::size_t i = first; i < last; ++i) {
+        if (scan_error err = conv.scan(std::string_view(cells[i]), out[i])) {
+            return {i, err};
+        }
+    }
+    return {};
+}
+
+} // namespace column_detail
+
+/// Parse cells[i] into out[i], for the rows both have. On error, rows
+/// past the bad one may or may not have been written.
+template <scannable T, std::ranges::random_access_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, std::string_view>
+column_error parse_column(R&& cells, std::span<T> out, column_options opt = {}) {
+    std::size_t n = std::min<std::size_t>(std::ranges::size(cells), out.size());
+    auto it = std::ranges::begin(cells);
+    unsigned threads = unsigned(std::clamp<std::size_t>(
+        n / column_detail::min_rows_per_thread, 1, std::max(opt.threads, 1u)));
+    if (threads <= 1) {
+        return column_detail::parse_rows(it, out, 0, n);
+    }
+    std::vector<column_error> errors(threads);
+    {
+        std::vector<std::jthread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                errors[t] = column_detail::parse_rows(it, out, n * t / threads,
+                                                      n * (t + 1) / threads);
+            });
+        }
+        errors[0] = column_detail::parse_rows(it, out, 0, n / threads);
+    }
+    // Pieces are in row order: the first piece with an error has the lowest row
+    for (auto& e : errors) {
+        if (e) {
+            return e;
+        }
+    }
+    return {};
+}
@@ -0,0 +1,202 @@
+#pragma GCC diagnostic ignored "-Wpsabi" // vectors passed between inlined helpers
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+template <class T, std::size_t Bytes>
+using vec_t [[gnu::vector_size(Bytes)]] = T;
+
+struct scan_options {
+    unsigned threads = 1;
+    // Split into fixed-size blocks, so that floating-point results are
+    // bit-identical for any thread count. Otherwise every thread gets one
+    // contiguous piece, and where the pieces start depends on `threads`.
+    bool deterministic = false;
+};
+
+namespace detail {
+
+inline constexpr std::size_t vec_bytes = 32;
+inline constexpr std::size_t fixed_block = 1 << 16; // elements
+
+template <class T>
+inline constexpr std::size_t lanes = vec_bytes / sizeof(T);
+
+template <class T>
+using vec = vec_t<T, vec_bytes>;
+
+// An integer vector of the same shape, for shuffle masks
+template <class T>
+using mask = vec_t<std::make_signed_t<std::conditional_t<
+                       sizeof(T) == 4, std::uint32_t, std::uint64_t>>,
+                   vec_bytes>;
+
+/// Shift lanes up by S, filling with zeros: [a, b, c, d] -> [0, a, b, c] for S = 1
+template <std::size_t S, class T>
+[[gnu::always_inline]] inline vec<T> shift_up(vec<T> v) {
+    constexpr std::size_t W = lanes<T>;
+    mask<T> m;
+    for (std::size_t i = 0; i < W; ++i) {
+        // indices >= W pick from the second operand, which is all zero
+        m[i] = i < S ? W : i - S;
+    }
+    return __builtin_shuffle(v, vec<T>{}, m);
+}
+
+/// Prefix sum inside one register, in log2(W) shift-and-add steps
+template <class T, std::size_t S = 1>
+[[gnu::always_inline]] inline vec<T> scan_in_register(vec<T> v) {
+    if constexpr (S >= lanes<T>) {
+        return v;
+    } else {
+        return scan_in_register<T, S * 2>(v + shift_up<S, T>(v));
+    }
+}
+
+/// Scan [first, first + n) starting from `carry`, return the new carry.
+/// With out == nullptr nothing is written; the carry comes out the same,
+/// so pass 1 (block totals) and pass 2 (the scan) agree to the bit.
+template <bool Inclusive, class T>
+T scan_block(const T* in, T* out, std::size_t n, T carry) {
+    constexpr std::size_t W = lanes<T>;
+    std::size_t i = 0;
+    for (; i + W <= n; i += W) {
+        vec<T> x;
+        std::memcpy(&x, in + i, sizeof(x));
+        vec<T> s = scan_in_register<T>(x);
+        if (out) {
+            vec<T> r = (Inclusive ? s : shift_up<1, T>(s)) + carry;
+            std::memcpy(out + i, &r, sizeof(r));
+        }
+        carry += s[W - 1];
+    }
+    for (; i < n; ++i) {
+        T x = in[i]; // read first: `in` and `out` may be the same
+        if (out) {
+            out[i] = Inclusive ? carry + x : carry;
+        }
+        carry += x;
+    }
+    return carry;
+}
+
+template <bool Inclusive, class T>
+void scan(std::span<const T> in, std::span<T> out, T init, scan_options opt) {
+    std::size_t n = std::min(in.size(), out.size());
+    unsigned threads = std::max(opt.threads, 1u);
+    std::size_t blocks = opt.deterministic ? (n + fixed_block - 1) / fixed_block
+                                           : std::min<std::size_t>(threads, n);
+    if (blocks <= 1) {
+        scan_block<Inclusive>(in.data(), out.data(), n, init);
+        return;
+    }
+    auto bounds = [&](std::size_t b) {
+        return opt.deterministic ? std::min(n, b * fixed_block) : n * b / blocks;
+    };
+
+    auto parallel = [&](auto f) {
+        std::vector<std::jthread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                for (auto b = blocks * t / threads; b < blocks * (t + 1) / threads; ++b) {
+                    f(b);
+                }
+            });
+        }
+        for (std::size_t b = 0; b < blocks / threads; ++b) {
+            f(b);
+        }
+    };
+
+    // Pass 1: block totals (reads the input)
+    std::vector<T> carry(blocks + 1);
+    parallel([&](std::size_t b) {
+        carry[b + 1] = scan_block<Inclusive, T>(in.data() + bounds(b), nullptr,
+                                                bounds(b + 1) - bounds(b), T{});
+    });
+    // Tiny sequential scan over the totals
+    carry[0] = init;
+    for (std::size_t b = 0; b < blocks; ++b) {
+        carry[b + 1] += carry[b];
+    }
+    // Pass 2: scan each block from its carry (reads the input, writes the output)
+    parallel([&](std::size_t b) {
+        scan_block<Inclusive>(in.data() + bounds(b), out.data() + bounds(b),
+                              bounds(b + 1) - bounds(b), carry[b]);
+    });
+}
+
+} // namespace detail
+
+/// out[i] = in[0] + ... + in[i].  `in` and `out` may be the same span.
+template <class T>
+void inclusive_scan(std::span<const T> in, std::span<T> out, scan_options opt = {}) {
+    detail::scan<true>(in, out, T{}, opt);
+}
+
+/// out[i] = init + in[0] + ... + in[i - 1]
+template <class T>
+void exclusive_scan(std::span<const T> in, std::span<T> out, T init,
+                    scan_options opt = {}) {
+    detail::scan<false>(in, out, init, opt);
+}
+
+template <class F>
+void bench(const char* name, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << name << ": "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+}
+
+int main() {
+    // Column lengths -> offsets, as in a columnar writer
+    std::mt19937_64 gen{60};
+    std::vector<std::int64_t> lengths(40'000'003);
+    for (auto& x : lengths) {
+        x = std::int64_t(gen() % 100);
+    }
+    std::vector<std::int64_t> expected(lengths.size()), offsets(lengths.size());
+
+    bench("std::exclusive_scan        ", [&] {
+        std::exclusive_scan(lengths.begin(), lengths.end(), expected.begin(),
+                            std::int64_t{0});
+    });
+    bench("exclusive_scan             ", [&] {
+        exclusive_scan<std::int64_t>(lengths, offsets, 0);
+    });
+    std::cout << (offsets == expected ? "  same" : "  DIFFERENT") << '\n';
+    bench("exclusive_scan, 4 threads  ", [&] {
+        exclusive_scan<std::int64_t>(lengths, offsets, 0, {.threads = 4});
+    });
+    std::cout << (offsets == expected ? "  same" : "  DIFFERENT") << '\n';
+
+    // In place
+    std::inclusive_scan(expected.begin(), expected.end(), expected.begin());
+    inclusive_scan<std::int64_t>(offsets, offsets, {.threads = 3});
+    std::cout << "in place: " << (offsets == expected ? "same" : "DIFFERENT") << '\n';
+
+    // Floating point: only the deterministic mode ignores the thread count
+    std::vector<double> xs(10'000'000), a(xs.size()), b(xs.size());
+    std::uniform_real_distribution<double> dist{-1, 1};
+    for (auto& x : xs) {
+        x = dist(gen);
+    }
+    for (bool det : {false, true}) {
+        inclusive_scan<double>(xs, a, {.threads = 2, .deterministic = det});
+        inclusive_scan<double>(xs, b, {.threads = 5, .deterministic = det});
+        bool same = std::memcmp(a.data(), b.data(), a.size() * sizeof(double)) == 0;
+        std::cout << (det ? "deterministic: " : "default:       ")
+                  << (same ? "bit-identical" : "differs") << " for 2 and 5 threads\n";
+    }
+}
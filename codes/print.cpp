@@ -0,0 +1,136 @@
+#include "print.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <fcntl.h>
+
+struct Point {
+    int x, y;
+};
+
+// The post's formatter, for whichever library print.hpp picked
+template <>
+struct fmt_lib::formatter<Point> {
+    constexpr auto parse(auto& ctx) {
+        return ctx.begin();
+    }
+    auto format(const Point& p, auto& ctx) const {
+        return fmt_lib::format_to(ctx.out(), "Point({}, {})", p.x, p.y);
+    }
+};
+
+/// Its formatter throws, as a bad dynamic spec or bad_alloc would
+struct Faulty {};
+
+template <>
+struct fmt_lib::formatter<Faulty> {
+    constexpr auto parse(auto& ctx) {
+        return ctx.begin();
+    }
+    auto format(Faulty, auto& ctx) const -> decltype(ctx.out()) {
+        throw fmt_lib::format_error("faulty");
+    }
+};
+
+template <class F>
+void bench(const char* name, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    println(STDERR_FILENO, "{}: {:.1f} ms", name,
+            std::chrono::duration<double, std::milli>(t1 - t0).count());
+}
+
+/// Everything written to a pipe by `f`
+template <class F>
+std::string capture(F f) {
+    int p[2];
+    if (::pipe(p) != 0) {
+        return {};
+    }
+    f(p[1]);
+    ::close(p[1]);
+    std::string out;
+    char buf[4096];
+    for (ssize_t n; (n = ::read(p[0], buf, sizeof(buf))) > 0;) {
+        out.append(buf, std::size_t(n));
+    }
+    ::close(p[0]);
+    return out;
+}
+
+int main() {
+    print("The answer is {}\n", 42);
+    println("{} and {}", Point{1, 2}, Point{3, 4});
+    // print("{} {}\n", 1);  // error at compile time: not enough arguments
+    // print("{:d}\n", "x"); // error at compile time: bad spec for a string
+
+    auto out = capture([](int fd) {
+        print(fd, "a{}", 1);
+        {
+            print_batch batch;
+            println(fd, "b{}", 2);
+            print(fd, "c{}\n", Point{3, 3});
+        }
+        println(fd, "d");
+    });
+    bool ok = out == "a1b2\nc" "Point(3, 3)\n" "d\n";
+    println(STDERR_FILENO, "pipe: {}", ok ? "as expected" : out);
+
+    // A throwing formatter leaves nothing behind, and later calls still write
+    auto after_throw = capture([](int fd) {
+        auto attempt = [](auto f) {
+            try {
+                f();
+            } catch (const fmt_lib::format_error&) {
+            }
+        };
+        attempt([&] { println(fd, "x{}", Faulty{}); });
+        println(fd, "e");
+        attempt([&] {
+            print_batch batch;
+            print(fd, "f\n");
+            print(fd, "y{}", Faulty{});
+        });
+        println(fd, "g");
+    });
+    bool throw_ok = after_throw == "e\nf\ng\n";
+    println(STDERR_FILENO, "after a throw: {}", throw_ok ? "as expected" : after_throw);
+    ok = ok && throw_ok;
+
+    // 1M log lines to /dev/null
+    int null = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    constexpr int lines = 1'000'000;
+
+    bench("cout << format, per line", [&] {
+        std::ios::sync_with_stdio(false);
+        auto* old = std::cout.rdbuf();
+        std::filebuf fb;
+        fb.open("/dev/null", std::ios::out);
+        std::cout.rdbuf(&fb);
+        for (int i = 0; i < lines; ++i) {
+            // flushed, to match print's one write per line
+            std::cout << fmt_lib::format("order {} filled at {:.2f}\n", i, i * 0.01)
+                      << std::flush;
+        }
+        std::cout.rdbuf(old);
+    });
+    bench("print, per line         ", [&] {
+        for (int i = 0; i < lines; ++i) {
+            print(null, "order {} filled at {:.2f}\n", i, i * 0.01);
+        }
+    });
+    bench("print, batches of 1000  ", [&] {
+        for (int i = 0; i < lines; i += 1000) {
+            print_batch batch;
+            for (int j = i; j < i + 1000; ++j) {
+                print(null, "order {} filled at {:.2f}\n", j, j * 0.01);
+            }
+        }
+    });
+    ::close(null);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,170 @@
+#pragma once
+
+// print() from "Experience with std::format", without the temporary
+// std::string and without iostreams:
+//
+//   print("The answer is {}\n", 42);        // checked at compile time
+//   print(STDERR_FILENO, "{} failed\n", what);
+//
+// Each call formats into a thread-local buffer, reused across calls, and
+// hands it to write(2) once. Inside a print_batch, calls on the thread
+// only append, and the batch writes once at the end.
+//
+// Uses <format> where the standard library has it (libstdc++ 13+), and
+// {fmt} otherwise: link with -lfmt.
+//
+// Not synchronized with std::cout's buffer; don't mix the two on one fd
+// without flushing std::cout first. Concurrent calls don't lock: each
+// write is one system call, and a write of up to PIPE_BUF bytes to a
+// pipe, or any write to an O_APPEND file, is not interleaved with others.
+
+#include <cerrno>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <version>
+
+#include <unistd.h>
+
+#if defined(__cpp_lib_format)
+#include <format>
+namespace fmt_lib = std;
+#else
+#include <fmt/format.h>
+namespace fmt_lib = fmt;
+#endif
+
+namespace print_detail {
+
+using fmt_lib::format_string;
+
+template <class FormatString> // format_string<Args...> can't deduce Args
+constexpr std::string_view view(const FormatString& fmt) noexcept {
+#if defined(__cpp_lib_format)
+    return fmt.get();
+#else
+    fmt::string_view s = fmt;
+    return {s.data(), s.size()};
+#endif
+}
+
+/// write(2) until done; false (errno set) on error
+inline bool write_all(int fd, const char* p, std::size_t n) noexcept {
+    while (n > 0) {
+        ssize_t w = ::write(fd, p, n);
+        if (w < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        p += w;
+        n -= std::size_t(w);
+    }
+    return true;
+}
+
+struct thread_buffer {
+    std::string text;
+    int fd = -1;        // where `text` goes, while batching
+    unsigned depth = 0; // nested print_batch scopes
+
+    bool flush() noexcept {
+        bool ok = write_all(fd, text.data(), text.size());
+        text.clear(); // keeps the capacity
+        return ok;
+    }
+};
+
+inline thread_local thread_buffer buffer;
+
+/// One level of batching for a scope, even if formatting throws
+struct defer_writes {
+    defer_writes() noexcept {
+        ++buffer.depth;
+    }
+    ~defer_writes() {
+        --buffer.depth;
+    }
+    defer_writes(const defer_writes&) = delete;
+    defer_writes& operator=(const defer_writes&) = delete;
+};
+
+// Batches flush early past this, so a long batch doesn't grow without bound
+inline constexpr std::size_t batch_limit = 64 << 10;
+
+/// Format into the thread's buffer, write unless batching. If formatting
+/// throws, what it appended is removed, and the exception propagates.
+/// Not a template on the arguments: one copy of this per format backend.
+inline bool vprint(int fd, std::string_view fmt, fmt_lib::format_args args) {
+    auto& b = buffer;
+    if (b.depth > 0 && b.fd != fd && !b.text.empty()) {
+        b.flush();
+    }
+    b.fd = fd;
+    std::size_t mark = b.text.size();
+    try {
+        fmt_lib::vformat_to(std::back_inserter(b.text), fmt, args);
+    } catch (...) {
+        b.text.resize(mark);
+        throw;
+    }
+    if (b.depth == 0 || b.text.size() >= batch_limit) {
+        return b.flush();
+    }
+    return true;
+}
+
+} // namespace print_detail
+
+/// Format and write to `fd`. Returns false, with errno set, if the
+/// write failed (before a batch ends, only past batch_limit).
+template <class... Args>
+bool print(int fd, print_detail::format_string<Args...> fmt, Args&&... args) {
+    return print_detail::vprint(fd, print_detail::view(fmt),
+                                fmt_lib::make_format_args(args...));
+}
+
+template <class... Args>
+bool print(print_detail::format_string<Args...> fmt, Args&&... args) {
+    return print_detail::vprint(STDOUT_FILENO, print_detail::view(fmt),
+                                fmt_lib::make_format_args(args...));
+}
+
+/// print, then a newline, in the same write
+template <class... Args>
+bool println(int fd, print_detail::format_string<Args...> fmt, Args&&... args) {
+    bool ok;
+    {
+        print_detail::defer_writes defer; // so the write includes the newline
+        ok = print_detail::vprint(fd, print_detail::view(fmt),
+                                  fmt_lib::make_format_args(args...));
+        print_detail::buffer.text += '\n';
+    }
+    return (print_detail::buffer.depth > 0 || print_detail::buffer.flush()) && ok;
+}
+
+template <class... Args>
+bool println(print_detail::format_string<Args...> fmt, Args&&... args) {
+    return println(STDOUT_FILENO, fmt, std::forward<Args>(args)...);
+}
+
+/// While alive, print and println on this thread append to one buffer,
+/// written at the end of the (outermost) batch: one system call for many
+/// lines. Switching fds inside a batch writes what was there first.
+class print_batch {
+public:
+    print_batch() noexcept {
+        ++print_detail::buffer.depth;
+    }
+    /// Also when unwinding: print and println leave no partial output
+    ~print_batch() {
+        if (--print_detail::buffer.depth == 0 && !print_detail::buffer.text.empty()) {
+            print_detail::buffer.flush();
+        }
+    }
+    print_batch(const print_batch&) = delete;
+    print_batch& operator=(const print_batch&) = delete;
+};
@@ -0,0 +1,97 @@
+#pragma once
+
+// The RAII wrappers from "std::unique_ptr as a Generic RAII Wrapper".
+// Shared by the examples that build on them.
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct fcloser {
+    void operator()(std::FILE* fp) const noexcept {
+        std::fclose(fp);
+    }
+};
+
+using file_ptr = std::unique_ptr<std::FILE, fcloser>;
+
+struct mem_unmapper {
+    size_t length{};
+
+    void operator()(void* addr) const noexcept {
+        ::munmap(addr, length);
+    }
+};
+
+using mapped_mem_ptr = std::unique_ptr<void, mem_unmapper>;
+
+[[nodiscard]] inline mapped_mem_ptr make_mapped_mem(void* addr, size_t length,
+                                                    int prot, int flags, int fd,
+                                                    off_t offset) {
+    void* p = ::mmap(addr, length, prot, flags, fd, offset);
+    if (p == MAP_FAILED) { // MAP_FAILED is not NULL
+        return nullptr;
+    }
+    return {p, mem_unmapper{length}};
+}
+
+// Minimally satisfy NullablePointer. Intentionally non-RAII
+class file_descriptor {
+    int fd_{-1};
+
+public:
+    constexpr file_descriptor(int fd = -1) noexcept : fd_(fd) {
+    }
+    constexpr file_descriptor(std::nullptr_t) noexcept {
+    }
+    constexpr operator int() const noexcept {
+        return fd_;
+    }
+    constexpr explicit operator bool() const noexcept {
+        return fd_ != -1;
+    }
+    friend constexpr bool operator==(file_descriptor,
+                                     file_descriptor) = default;
+};
+
+struct fd_closer {
+    using pointer = file_descriptor; // IMPORTANT
+    void operator()(pointer fd) const noexcept {
+        ::close(int(fd));
+    }
+};
+
+struct unix_file;
+using unique_fd = std::unique_ptr<unix_file, fd_closer>;
+
+// Factory, so that callers never hit the `unique_fd{0}` gotcha
+[[nodiscard]] inline unique_fd make_unique_fd(int fd) noexcept {
+    return unique_fd{file_descriptor(fd)};
+}
+
+[[nodiscard]] inline unique_fd open_fd(const char* path, int flags,
+                                       mode_t mode = 0644) noexcept {
+    return make_unique_fd(::open(path, flags | O_CLOEXEC, mode));
+}
+
+// Memory from std::aligned_alloc
+struct aligned_freer {
+    void operator()(void* p) const noexcept {
+        std::free(p);
+    }
+};
+
+using aligned_bytes_ptr = std::unique_ptr<std::byte[], aligned_freer>;
+
+[[nodiscard]] inline aligned_bytes_ptr make_aligned_bytes(size_t alignment,
+                                                          size_t size) {
+    // aligned_alloc requires size to be a multiple of alignment
+    size = (size + alignment - 1) / alignment * alignment;
+    return aligned_bytes_ptr{
+        static_cast<std::byte*>(std::aligned_alloc(alignment, size))};
+}
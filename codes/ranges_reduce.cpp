@@ -0,0 +1,414 @@
+// g++ -std=c++23 -O2 ranges_reduce.cpp -ltbb   (libstdc++'s <execution> wants TBB)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <exception>
+#include <execution>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// A fixed set of threads that run `f(0) ... f(n - 1)`.
+/// Every thread starts with an even share of the indices, takes work from
+/// the front of its own share, and when it runs dry steals half of what is
+/// left from the back of someone else's.
+class work_stealing_pool {
+    struct share {
+        std::mutex m;
+        std::size_t lo = 0, hi = 0;
+    };
+
+    unsigned size_;
+    std::unique_ptr<share[]> shares_;
+
+    std::mutex run_mtx_; // one job at a time; jobs must not nest
+    std::mutex mtx_;
+    std::condition_variable_any start_cv_;
+    std::condition_variable done_cv_;
+    const std::function<void(std::size_t)>* job_ = nullptr;
+    std::uint64_t generation_ = 0;
+    unsigned busy_ = 0;
+    std::exception_ptr error_;
+
+    std::vector<std::jthread> threads_; // last, so that it is joined first
+
+    bool pop(unsigned self, std::size_t& i) {
+        auto& s = shares_[self];
+        std::lock_guard lk{s.m};
+        if (s.lo == s.hi) {
+            return false;
+        }
+        i = s.lo++;
+        return true;
+    }
+
+    bool steal(unsigned self) {
+        for (unsigned k = 1; k < size_; ++k) {
+            auto& victim = shares_[(self + k) % size_];
+            std::size_t lo, hi;
+            {
+                std::lock_guard lk{victim.m};
+                if (victim.hi - victim.lo < 1) {
+                    continue;
+                }
+                hi = victim.hi;
+                lo = victim.hi -= (victim.hi - victim.lo + 1) / 2;
+            }
+            auto& mine = shares_[self];
+            std::lock_guard lk{mine.m};
+            mine.lo = lo;
+            mine.hi = hi;
+            return true;
+        }
+        return false;
+    }
+
+    void participate(unsigned self) {
+        try {
+            for (;;) {
+                std::size_t i;
+                if (pop(self, i)) {
+                    (*job_)(i);
+                } else if (!steal(self)) {
+                    return;
+                }
+            }
+        } catch (...) {
+            std::lock_guard lk{mtx_};
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+            // Abandon the rest of our share; other threads finish theirs
+            auto& s = shares_[self];
+            std::lock_guard slk{s.m};
+            s.lo = s.hi;
+        }
+    }
+
+    void worker(std::stop_token st, unsigned self) {
+        std::uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock lk{mtx_};
+                if (!start_cv_.wait(lk, st, [&] { return generation_ != seen; })) {
+                    return;
+                }
+                seen = generation_;
+            }
+            participate(self);
+            std::lock_guard lk{mtx_};
+            if (--busy_ == 0) {
+                done_cv_.notify_one();
+            }
+        }
+    }
+
+public:
+    explicit work_stealing_pool(unsigned size = std::thread::hardware_concurrency())
+        : size_(std::max(size, 1u)), shares_(new share[size_]) {
+        // The calling thread is worker 0
+        for (unsigned t = 1; t < size_; ++t) {
+            threads_.emplace_back([this, t](std::stop_token st) { worker(st, t); });
+        }
+    }
+
+    unsigned size() const noexcept {
+        return size_;
+    }
+
+    void run(std::size_t n, const std::function<void(std::size_t)>& f) {
+        std::lock_guard run_lk{run_mtx_};
+        for (unsigned t = 0; t < size_; ++t) {
+            std::lock_guard lk{shares_[t].m};
+            shares_[t].lo = n * t / size_;
+            shares_[t].hi = n * (t + 1) / size_;
+        }
+        {
+            std::lock_guard lk{mtx_};
+            job_ = &f;
+            error_ = nullptr;
+            busy_ = size_ - 1;
+            ++generation_;
+        }
+        start_cv_.notify_all();
+        participate(0);
+
+        std::unique_lock lk{mtx_};
+        done_cv_.wait(lk, [&] { return busy_ == 0; });
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+};
+
+inline work_stealing_pool& default_pool() {
+    static work_stealing_pool pool;
+    return pool;
+}
+
+namespace my::ranges {
+
+/// Opt-in: `op(op(a, b), c) == op(a, op(b, c))`, "close enough" for
+/// floating point, exactly as std::reduce assumes it.
+/// For ops without it, reduce() is fold_left, whatever the policy says.
+template <class Op, class T>
+inline constexpr bool is_associative_v = false;
+
+template <class T, class U>
+inline constexpr bool is_associative_v<std::plus<U>, T> = true;
+template <class T, class U>
+inline constexpr bool is_associative_v<std::multiplies<U>, T> = true;
+template <class T, class U>
+inline constexpr bool is_associative_v<std::bit_and<U>, T> = true;
+template <class T, class U>
+inline constexpr bool is_associative_v<std::bit_or<U>, T> = true;
+template <class T, class U>
+inline constexpr bool is_associative_v<std::bit_xor<U>, T> = true;
+template <class T>
+inline constexpr bool is_associative_v<std::remove_cvref_t<decltype(std::ranges::min)>, T> = true;
+template <class T>
+inline constexpr bool is_associative_v<std::remove_cvref_t<decltype(std::ranges::max)>, T> = true;
+
+/// Whether elements may also be reordered, not just regrouped.
+/// Then a chunk can be spread across independent accumulators,
+/// which is what the vectorizer needs.
+template <class Op, class T>
+inline constexpr bool is_lane_reducible_v =
+    is_associative_v<Op, T> && std::is_arithmetic_v<T>;
+
+namespace detail {
+
+// Chunks small enough to stay in L2 while being reduced
+inline constexpr std::size_t chunk_bytes = 64 << 10;
+
+template <class P>
+inline constexpr bool is_parallel_v =
+    std::is_same_v<std::remove_cvref_t<P>, std::execution::parallel_policy> ||
+    std::is_same_v<std::remove_cvref_t<P>, std::execution::parallel_unsequenced_policy>;
+
+template <class P>
+inline constexpr bool is_unsequenced_v =
+    std::is_same_v<std::remove_cvref_t<P>, std::execution::unsequenced_policy> ||
+    std::is_same_v<std::remove_cvref_t<P>, std::execution::parallel_unsequenced_policy>;
+
+// Eight accumulators of type T, seeded with the first eight elements, so no
+// identity element is needed (there is none for min/max).
+template <class T, class V, class Op>
+std::optional<T> lanes_reduce(const V* first, std::size_t n, Op& op) {
+    constexpr std::size_t lanes = 8;
+    if (n < lanes) {
+        if (n == 0) {
+            return std::nullopt;
+        }
+        T r = T(first[0]);
+        for (std::size_t i = 1; i < n; ++i) {
+            r = op(r, first[i]);
+        }
+        return r;
+    }
+    T acc[lanes];
+    for (std::size_t j = 0; j < lanes; ++j) {
+        acc[j] = T(first[j]);
+    }
+    std::size_t i = lanes;
+    for (; i + lanes <= n; i += lanes) {
+        for (std::size_t j = 0; j < lanes; ++j) {
+            acc[j] = op(acc[j], first[i + j]);
+        }
+    }
+    for (std::size_t j = 0; i < n; ++i, ++j) {
+        acc[j] = op(acc[j], first[i]);
+    }
+    for (std::size_t w = lanes / 2; w > 0; w /= 2) {
+        for (std::size_t j = 0; j < w; ++j) {
+            acc[j] = op(acc[j], acc[j + w]);
+        }
+    }
+    return acc[0];
+}
+
+template <class It, class T, class Op>
+T fold(It first, It last, T init, Op& op) {
+    for (; first != last; ++first) {
+        init = op(std::move(init), *first);
+    }
+    return init;
+}
+
+} // namespace detail
+
+template <class E, std::ranges::input_range R, class T, class Op>
+    requires std::is_execution_policy_v<std::remove_cvref_t<E>>
+T reduce(E&&, R&& r, T init, Op op) {
+    using V = std::ranges::range_value_t<R>;
+
+    // Like std::reduce, everything accumulates in T, the type of `init`:
+    // int elements with a long long init are summed as long long
+    if constexpr (!is_associative_v<Op, T> || !std::ranges::random_access_range<R>) {
+        // Not ours to regroup (or not splittable): plain fold_left
+        return detail::fold(std::ranges::begin(r), std::ranges::end(r),
+                            std::move(init), op);
+    } else {
+        // Only regroups elements for contiguous arithmetic input, and only
+        // when the policy allows that; otherwise each chunk is a fold_left.
+        constexpr bool lanes = detail::is_unsequenced_v<E> &&
+                               is_lane_reducible_v<Op, T> &&
+                               std::is_arithmetic_v<V> &&
+                               std::ranges::contiguous_range<R>;
+        auto first = std::ranges::begin(r);
+        auto n = static_cast<std::size_t>(std::ranges::distance(r));
+
+        auto reduce_chunk = [&](std::size_t lo, std::size_t hi) -> std::optional<T> {
+            if (lo == hi) {
+                return std::nullopt;
+            }
+            if constexpr (lanes) {
+                return detail::lanes_reduce<T>(std::to_address(first) + lo, hi - lo, op);
+            } else {
+                auto it = first + lo;
+                return detail::fold(it + 1, first + hi, T(*it), op);
+            }
+        };
+
+        if constexpr (!detail::is_parallel_v<E>) {
+            if (auto v = reduce_chunk(0, n)) {
+                return op(std::move(init), std::move(*v));
+            }
+            return init;
+        } else {
+            constexpr std::size_t chunk = std::max<std::size_t>(detail::chunk_bytes / sizeof(V), 1);
+            std::size_t chunks = (n + chunk - 1) / chunk;
+            if (chunks <= 1) {
+                // Not worth waking the pool; same grouping rules, one thread
+                if constexpr (detail::is_unsequenced_v<E>) {
+                    return ranges::reduce(std::execution::unseq, std::forward<R>(r),
+                                          std::move(init), op);
+                } else {
+                    return ranges::reduce(std::execution::seq, std::forward<R>(r),
+                                          std::move(init), op);
+                }
+            }
+            std::vector<std::optional<T>> partials(chunks);
+            default_pool().run(chunks, [&](std::size_t c) {
+                partials[c] = reduce_chunk(c * chunk, std::min(n, (c + 1) * chunk));
+            });
+            // In chunk order, so associativity alone is enough
+            for (auto& p : partials) {
+                init = op(std::move(init), std::move(*p));
+            }
+            return init;
+        }
+    }
+}
+
+template <class E, std::ranges::input_range R, class T>
+    requires std::is_execution_policy_v<std::remove_cvref_t<E>>
+T reduce(E&& policy, R&& r, T init) {
+    return ranges::reduce(std::forward<E>(policy), std::forward<R>(r),
+                          std::move(init), std::plus<>{});
+}
+
+template <class E, std::ranges::input_range R>
+    requires std::is_execution_policy_v<std::remove_cvref_t<E>>
+auto reduce(E&& policy, R&& r) {
+    return ranges::reduce(std::forward<E>(policy), std::forward<R>(r),
+                          std::ranges::range_value_t<R>{}, std::plus<>{});
+}
+
+template <std::ranges::input_range R, class T, class Op>
+T reduce(R&& r, T init, Op op) {
+    return ranges::reduce(std::execution::seq, std::forward<R>(r),
+                          std::move(init), std::move(op));
+}
+
+template <std::ranges::input_range R, class T>
+T reduce(R&& r, T init) {
+    return ranges::reduce(std::execution::seq, std::forward<R>(r), std::move(init));
+}
+
+template <std::ranges::input_range R>
+auto reduce(R&& r) {
+    return ranges::reduce(std::execution::seq, std::forward<R>(r));
+}
+
+// The iterator-pair forms are just the range forms over a subrange
+
+template <class E, std::input_iterator I, std::sentinel_for<I> S, class T, class Op>
+    requires std::is_execution_policy_v<std::remove_cvref_t<E>>
+T reduce(E&& policy, I first, S last, T init, Op op) {
+    return ranges::reduce(std::forward<E>(policy), std::ranges::subrange(first, last),
+                          std::move(init), std::move(op));
+}
+
+template <std::input_iterator I, std::sentinel_for<I> S, class T, class Op>
+T reduce(I first, S last, T init, Op op) {
+    return ranges::reduce(std::ranges::subrange(first, last), std::move(init),
+                          std::move(op));
+}
+
+} // namespace my::ranges
+
+template <class F>
+auto bench(const char* name, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    auto r = f();
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << name << ": " << r << ", "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+    return r;
+}
+
+int main() {
+    namespace ex = std::execution;
+    namespace rg = my::ranges;
+
+    std::mt19937_64 gen{7};
+    std::uniform_real_distribution<double> dist{0, 1};
+    std::vector<double> nums(50'000'000);
+    for (auto& x : nums) {
+        x = dist(gen);
+    }
+
+    bench("std::accumulate     ", [&] { return std::accumulate(nums.begin(), nums.end(), 0.0); });
+    bench("std::reduce         ", [&] { return std::reduce(nums.begin(), nums.end()); });
+    bench("reduce(seq)         ", [&] { return rg::reduce(ex::seq, nums, 0.0); });
+    bench("reduce(unseq)       ", [&] { return rg::reduce(ex::unseq, nums, 0.0); });
+    bench("reduce(par)         ", [&] { return rg::reduce(ex::par, nums, 0.0); });
+    bench("reduce(par_unseq)   ", [&] { return rg::reduce(ex::par_unseq, nums, 0.0); });
+    bench("min, par_unseq      ", [&] { return rg::reduce(ex::par_unseq, nums, 2.0, std::ranges::min); });
+
+    // Associative but not commutative: chunks are combined in order
+    std::vector<std::string> words(200'000);
+    for (std::size_t i = 0; i < words.size(); ++i) {
+        words[i] = std::to_string(i % 10);
+    }
+    auto seq = rg::reduce(ex::seq, words, std::string{});
+    auto par = rg::reduce(ex::par, words, std::string{});
+    std::cout << "string concatenation: " << (seq == par ? "same" : "DIFFERENT") << '\n';
+
+    // Accumulates in the type of init, as std::reduce does
+    std::vector<int> big{INT_MAX, INT_MAX, 2};
+    bool widened = rg::reduce(big, 0LL) == 4294967296LL &&
+                   rg::reduce(ex::unseq, big, 0LL) == 4294967296LL;
+    std::vector<int> many(100'000, INT_MAX);
+    widened = widened && rg::reduce(ex::par, many, 0LL) == 100'000LL * INT_MAX &&
+              rg::reduce(ex::par_unseq, many, 0LL) == 100'000LL * INT_MAX;
+    std::cout << "int into long long: " << (widened ? "widened" : "OVERFLOWED") << '\n';
+
+    // Not associative: left fold, even when asked for par_unseq
+    auto diff = rg::reduce(ex::par_unseq, nums | std::views::take(1000), 0.0, std::minus<>{});
+    auto left = std::accumulate(nums.begin(), nums.begin() + 1000, 0.0, std::minus<>{});
+    std::cout << "minus: " << (diff == left ? "same as fold_left" : "DIFFERENT") << '\n';
+}
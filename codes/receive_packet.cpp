@@ -0,0 +1,136 @@
+#include "packet.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+struct wire_header {
+    std::uint32_t seq;
+    std::uint16_t type; // 0: data, 1: end of stream
+    std::uint16_t length;
+};
+
+/// `count` datagrams of `body` bytes each, then an end marker.
+/// sendmmsg in batches, so the sender isn't what's measured.
+void send_all(int fd, std::uint32_t count, std::size_t body) {
+    constexpr unsigned batch = 64;
+    std::vector<std::byte> bufs(batch * (sizeof(wire_header) + body));
+    std::vector<iovec> iovs(batch);
+    std::vector<mmsghdr> msgs(batch);
+    for (std::uint32_t seq = 0; seq <= count;) {
+        unsigned n = 0;
+        for (; n < batch && seq <= count; ++n, ++seq) {
+            std::byte* p = bufs.data() + n * (sizeof(wire_header) + body);
+            wire_header h{seq, std::uint16_t(seq == count), std::uint16_t(body)};
+            std::memcpy(p, &h, sizeof(h));
+            std::memset(p + sizeof(h), int(seq & 0xff), body);
+            iovs[n] = {p, sizeof(h) + body};
+            msgs[n] = {};
+            msgs[n].msg_hdr.msg_iov = &iovs[n];
+            msgs[n].msg_hdr.msg_iovlen = 1;
+        }
+        for (unsigned sent = 0; sent < n;) {
+            int r = ::sendmmsg(fd, msgs.data() + sent, n - sent, 0);
+            if (r < 0) {
+                if (errno == ENOBUFS || errno == EAGAIN) { // UDP: let the reader drain
+                    std::this_thread::yield();
+                    continue;
+                }
+                std::perror("sendmmsg");
+                return;
+            }
+            sent += unsigned(r);
+        }
+    }
+}
+
+/// Receive until the end marker; checks order and contents
+bool receive_all(int fd, std::uint32_t count, bool lossy, const char* name) {
+    packet_source<wire_header> src{fd};
+    std::uint32_t expect = 0, got = 0;
+    bool ok = true;
+    auto t0 = std::chrono::steady_clock::now();
+#if defined(__cpp_structured_bindings) && __cpp_structured_bindings >= 202406L
+    while (auto [header, body] = src.receive_packet()) {
+#else
+    while (auto p = src.receive_packet()) {
+        auto [header, body] = p;
+#endif
+        if (header->type == 1) {
+            break;
+        }
+        // UDP may drop under load, but never reorders on loopback
+        ok = ok && (lossy ? header->seq >= expect : header->seq == expect) &&
+             body.size() == header->length &&
+             (body.empty() || body[0] == std::byte(header->seq & 0xff));
+        expect = header->seq + 1;
+        ++got;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    std::cout << name << ": " << got << "/" << count << " packets in " << src.batches()
+              << " recvmmsg calls, " << ns / got << " ns/packet"
+              << (ok ? "" : ", OUT OF ORDER") << '\n';
+    return ok && src.error() == 0 && (lossy || got == count);
+}
+
+bool run(int rx, int tx, std::uint32_t count, std::size_t body, bool lossy, const char* name) {
+    std::jthread sender([&] { send_all(tx, count, body); });
+    return receive_all(rx, count, lossy, name);
+}
+
+int main() {
+    constexpr std::uint32_t count = 1'000'000;
+    bool ok = true;
+
+    {
+        int sv[2];
+        ::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, sv);
+        auto rx = make_unique_fd(sv[0]);
+        auto tx = make_unique_fd(sv[1]);
+        ok &= run(rx.get(), tx.get(), count, 64, false, "unix dgram");
+    }
+    {
+        auto rx = make_unique_fd(::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0));
+        auto tx = make_unique_fd(::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0));
+        int rcvbuf = 8 << 20;
+        ::setsockopt(rx.get(), SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        ::bind(rx.get(), reinterpret_cast<sockaddr*>(&addr), len);
+        ::getsockname(rx.get(), reinterpret_cast<sockaddr*>(&addr), &len);
+        ::connect(tx.get(), reinterpret_cast<sockaddr*>(&addr), len);
+        // The end marker may be dropped too: stop on a receive timeout
+        timeval timeout{0, 200'000};
+        ::setsockopt(rx.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        ok &= run(rx.get(), tx.get(), count, 64, true, "udp loopback");
+    }
+    {
+        // Short and oversized datagrams are skipped, not returned
+        int sv[2];
+        ::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, sv);
+        auto rx = make_unique_fd(sv[0]);
+        auto tx = make_unique_fd(sv[1]);
+        std::vector<std::byte> big(4096);
+        ::send(tx.get(), big.data(), 3, 0);
+        ::send(tx.get(), big.data(), big.size(), 0);
+        wire_header h{7, 0, 0};
+        ::send(tx.get(), &h, sizeof(h), 0);
+        packet_source<wire_header> src{rx.get(), {.wait = false}};
+        auto p = src.receive_packet();
+        bool good = p && p.header->seq == 7 && p.body.empty() && src.skipped() == 2 &&
+                    !src.receive_packet() && src.error() == 0;
+        std::cout << "skipped: " << (good ? "as expected" : "FAILED") << '\n';
+        ok &= good;
+    }
+    return ok ? 0 : 1;
+}
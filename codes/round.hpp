@@ -0,0 +1,410 @@
+#pragma once
+
+// The rounding family from "Round To Multiple",
+// plus `divisor<T>`: division by an invariant integer as multiply and shift.
+
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+template <class T>
+constexpr T round_up(T n, T m) {
+    assert(m > T{0});
+    return (n / m + ((n > T{0}) & bool(n % m))) * m;
+}
+
+template <class T>
+constexpr T round_dn(T n, T m) {
+    assert(m > T{0});
+    return (n / m - ((n < T{0}) & bool(n % m))) * m;
+}
+
+template <class T>
+constexpr T round_closest(T n, T m) {
+    auto lo = round_dn(n, m);
+    auto hi = round_up(n, m);
+    return (n - lo < hi - n) ? lo : hi;
+}
+
+namespace detail {
+
+template <class T>
+struct wider;
+template <>
+struct wider<std::int32_t> {
+    using type = std::int64_t;
+};
+template <>
+struct wider<std::int64_t> {
+    using type = __int128;
+};
+
+/// High half of the full product
+template <class T>
+constexpr T mulhi(T a, T b) noexcept {
+    using W = typename wider<T>::type;
+    return T((W(a) * W(b)) >> (sizeof(T) * CHAR_BIT));
+}
+
+} // namespace detail
+
+/// Truncating division by a fixed positive `m`, without a divide instruction.
+/// Magic number and shift as in Hacker's Delight, 10-1 (also what libdivide
+/// and compilers do for constant divisors), computed once at construction.
+template <class T>
+    requires std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t>
+class divisor {
+    using U = std::make_unsigned_t<T>;
+    static constexpr int bits = sizeof(T) * CHAR_BIT;
+
+    T m_;
+    T magic_{};
+    int shift_{};
+    bool add_{}; // the magic number wrapped negative: add n back
+
+public:
+    constexpr explicit divisor(T m) noexcept : m_(m) {
+        assert(m > T{0});
+        if (m == 1) {
+            return; // magic_ == 0 marks "identity"
+        }
+        const U two_p = U(1) << (bits - 1);
+        const U ad = U(m);
+        const U anc = two_p - 1 - two_p % ad; // |nc|
+        int p = bits - 1;
+        U q1 = two_p / anc, r1 = two_p - q1 * anc;
+        U q2 = two_p / ad, r2 = two_p - q2 * ad;
+        U delta;
+        do {
+            ++p;
+            q1 *= 2;
+            r1 *= 2;
+            if (r1 >= anc) {
+                ++q1;
+                r1 -= anc;
+            }
+            q2 *= 2;
+            r2 *= 2;
+            if (r2 >= ad) {
+                ++q2;
+                r2 -= ad;
+            }
+            delta = ad - r2;
+        } while (q1 < delta || (q1 == delta && r1 == 0));
+        magic_ = T(q2 + 1);
+        shift_ = p - bits;
+        add_ = magic_ < 0;
+    }
+
+    constexpr T value() const noexcept {
+        return m_;
+    }
+    constexpr T magic() const noexcept {
+        return magic_;
+    }
+    constexpr int shift() const noexcept {
+        return shift_;
+    }
+    constexpr bool add() const noexcept {
+        return add_;
+    }
+
+    /// n / m, rounded toward zero, same as the built-in operator
+    constexpr T quotient(T n) const noexcept {
+        if (magic_ == 0) {
+            return n;
+        }
+        T q = detail::mulhi(magic_, n);
+        if (add_) {
+            q += n;
+        }
+        q >>= shift_;
+        return q - (q >> (bits - 1)); // +1 if negative: floor -> truncation
+    }
+
+    friend constexpr T operator/(T n, const divisor& d) noexcept {
+        return d.quotient(n);
+    }
+    friend constexpr T operator%(T n, const divisor& d) noexcept {
+        return n - d.quotient(n) * d.m_;
+    }
+};
+
+// With a precomputed divisor: same results, no `idiv`
+
+template <class T>
+constexpr T round_up(T n, const divisor<T>& m) noexcept {
+    T q = n / m;
+    return (q + ((n > T{0}) & bool(n - q * m.value()))) * m.value();
+}
+
+template <class T>
+constexpr T round_dn(T n, const divisor<T>& m) noexcept {
+    T q = n / m;
+    return (q - ((n < T{0}) & bool(n - q * m.value()))) * m.value();
+}
+
+template <class T>
+constexpr T round_closest(T n, const divisor<T>& m) noexcept {
+    auto lo = round_dn(n, m);
+    auto hi = round_up(n, m);
+    return (n - lo < hi - n) ? lo : hi;
+}
+
+// With M known at compile time, e.g. round_up<64>(n) for alignment.
+// Powers of two are pure bit operations: in two's complement, clearing
+// the low bits rounds toward negative infinity, for negative n too.
+// Other M go through a constexpr divisor, whose magic number is computed
+// by the compiler.
+
+namespace detail {
+
+template <auto M>
+inline constexpr bool is_pow2 = M > 0 && (M & (M - 1)) == 0;
+
+template <auto M, class T>
+inline constexpr T low_mask = T(M) - 1;
+
+template <class T>
+inline constexpr bool has_divisor =
+    std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t>;
+
+} // namespace detail
+
+template <auto M, std::integral T>
+constexpr T round_dn(T n) noexcept {
+    static_assert(M > 0);
+    if constexpr (detail::is_pow2<M>) {
+        return n & ~detail::low_mask<M, T>;
+    } else if constexpr (detail::has_divisor<T>) {
+        constexpr divisor<T> d{T(M)};
+        return round_dn(n, d);
+    } else {
+        return round_dn(n, T(M));
+    }
+}
+
+template <auto M, std::integral T>
+constexpr T round_up(T n) noexcept {
+    static_assert(M > 0);
+    if constexpr (detail::is_pow2<M>) {
+        // Not (n + M - 1) & ~(M - 1): that overflows near the maximum
+        T lo = n & ~detail::low_mask<M, T>;
+        return lo + T(bool(n & detail::low_mask<M, T>)) * T(M);
+    } else if constexpr (detail::has_divisor<T>) {
+        constexpr divisor<T> d{T(M)};
+        return round_up(n, d);
+    } else {
+        return round_up(n, T(M));
+    }
+}
+
+template <auto M, std::integral T>
+constexpr T round_closest(T n) noexcept {
+    static_assert(M > 0);
+    if constexpr (detail::is_pow2<M>) {
+        T lo = n & ~detail::low_mask<M, T>;
+        T r = n & detail::low_mask<M, T>; // n - lo, in [0, M)
+        // hi - n == M - r; ties go up
+        return lo + T(r >= T(M) - r) * T(M);
+    } else if constexpr (detail::has_divisor<T>) {
+        constexpr divisor<T> d{T(M)};
+        return round_closest(n, d);
+    } else {
+        return round_closest(n, T(M));
+    }
+}
+
+// Overflow-aware variants.
+//
+// The plain versions require the result to be representable; round_up
+// near the maximum (or round_dn near the minimum) silently wraps.
+// These compute the same quotient, then do the only multiplication that
+// can overflow with __builtin_mul_overflow. No branches: the overflow
+// flag comes out of the multiply, so they also work in batch loops.
+//
+// `m` is a positive T or a divisor<T>.
+
+namespace detail {
+
+template <class T>
+constexpr T value_of(T m) noexcept {
+    return m;
+}
+template <class T>
+constexpr T value_of(const divisor<T>& m) noexcept {
+    return m.value();
+}
+
+/// Quotient of the result, i.e. result == q * m
+template <class T, class D>
+constexpr T up_quotient(T n, const D& m) noexcept {
+    T q = n / m;
+    T r = n - q * value_of(m); // can't overflow: |r| < m
+    return q + ((n > T{0}) & (r != T{0}));
+}
+
+template <class T, class D>
+constexpr T dn_quotient(T n, const D& m) noexcept {
+    T q = n / m;
+    T r = n - q * value_of(m);
+    return q - ((n < T{0}) & (r != T{0}));
+}
+
+template <class T, class D>
+constexpr T closest_quotient(T n, const D& m) noexcept {
+    T mv = value_of(m);
+    T q = n / m;
+    T r = n - q * mv;
+    bool neg = (n < T{0}) & (r != T{0});
+    T lo = q - neg;      // floor quotient
+    T rf = r + neg * mv; // n - lo * m, in [0, m), without computing lo * m
+    // n - lo < hi - n  <=>  rf < m - rf; ties go up, as round_closest
+    return lo + (rf >= mv - rf) * (rf != T{0});
+}
+
+} // namespace detail
+
+/// Like __builtin_mul_overflow: writes the (wrapped) result to `out`,
+/// returns true if it did not fit
+template <class T, class D>
+constexpr bool round_up_overflow(T n, const D& m, T* out) noexcept {
+    return __builtin_mul_overflow(detail::up_quotient(n, m), detail::value_of(m), out);
+}
+
+template <class T, class D>
+constexpr bool round_dn_overflow(T n, const D& m, T* out) noexcept {
+    return __builtin_mul_overflow(detail::dn_quotient(n, m), detail::value_of(m), out);
+}
+
+template <class T, class D>
+constexpr bool round_closest_overflow(T n, const D& m, T* out) noexcept {
+    return __builtin_mul_overflow(detail::closest_quotient(n, m),
+                                  detail::value_of(m), out);
+}
+
+// std::nullopt if the result is not representable
+
+template <class T, class D>
+constexpr std::optional<T> checked_round_up(T n, const D& m) noexcept {
+    T r;
+    return round_up_overflow(n, m, &r) ? std::nullopt : std::optional<T>{r};
+}
+
+template <class T, class D>
+constexpr std::optional<T> checked_round_dn(T n, const D& m) noexcept {
+    T r;
+    return round_dn_overflow(n, m, &r) ? std::nullopt : std::optional<T>{r};
+}
+
+template <class T, class D>
+constexpr std::optional<T> checked_round_closest(T n, const D& m) noexcept {
+    T r;
+    return round_closest_overflow(n, m, &r) ? std::nullopt : std::optional<T>{r};
+}
+
+// Saturate to the representable multiple of m nearest to the true result,
+// so the result is always a multiple of m (what an alignment needs),
+// even though it can then be < n for round_up.
+
+template <class T, class D>
+constexpr T saturating_round_up(T n, const D& m) noexcept {
+    T r;
+    bool over = round_up_overflow(n, m, &r);
+    T top = std::numeric_limits<T>::max() / m * detail::value_of(m);
+    return over ? top : r;
+}
+
+template <class T, class D>
+constexpr T saturating_round_dn(T n, const D& m) noexcept {
+    T r;
+    bool over = round_dn_overflow(n, m, &r);
+    T bottom = std::numeric_limits<T>::min() / m * detail::value_of(m);
+    return over ? bottom : r;
+}
+
+template <class T, class D>
+constexpr T saturating_round_closest(T n, const D& m) noexcept {
+    T r;
+    bool over = round_closest_overflow(n, m, &r);
+    T top = std::numeric_limits<T>::max() / m * detail::value_of(m);
+    T bottom = std::numeric_limits<T>::min() / m * detail::value_of(m);
+    return over ? (n > T{0} ? top : bottom) : r;
+}
+
+// Rounding with an explicit mode: to integers (any T or divisor<T>)
+// and to floating-point multiples. Same precondition as round_up and
+// friends: the result is representable.
+
+enum class rounding {
+    down,             // toward -inf, as round_dn
+    up,               // toward +inf, as round_up
+    toward_zero,
+    away_from_zero,
+    nearest_ties_up,  // as round_closest
+    nearest_ties_even,
+    nearest_ties_away,
+};
+
+namespace detail {
+
+/// Whether to take the multiple above the floor one. `cmp` is the sign of
+/// (distance to the floor multiple) - (distance to the one above).
+constexpr bool take_above(rounding mode, bool negative, bool odd, bool exact,
+                          int cmp) noexcept {
+    switch (mode) {
+    case rounding::down:
+        return false;
+    case rounding::up:
+        return !exact;
+    case rounding::toward_zero:
+        return !exact && negative;
+    case rounding::away_from_zero:
+        return !exact && !negative;
+    case rounding::nearest_ties_up:
+        return cmp >= 0;
+    case rounding::nearest_ties_even:
+        return cmp > 0 || (cmp == 0 && odd);
+    case rounding::nearest_ties_away:
+        return cmp > 0 || (cmp == 0 && !negative);
+    }
+    return false;
+}
+
+} // namespace detail
+
+template <std::integral T, class D>
+constexpr T round_to(T n, const D& m, rounding mode) noexcept {
+    T mv = detail::value_of(m);
+    T q = n / m;
+    T r = n - q * mv;
+    bool neg = (n < T{0}) & (r != T{0});
+    T lo = q - neg;      // floor quotient
+    T rf = r + neg * mv; // n - lo * m, in [0, m)
+    T rest = mv - rf;    // (lo + 1) * m - n
+    int cmp = (rf > rest) - (rf < rest);
+    return (lo + detail::take_above(mode, n < T{0}, lo & T{1}, rf == T{0}, cmp)) * mv;
+}
+
+/// x rounded to an integer multiple of m, m > 0, |x / m| < 2^51.
+///
+/// Exact with respect to the binary values of x and m: x / m is only
+/// used as a guess, and fused multiply-adds decide which side of a
+/// multiple x is on (their results are rounded once, so the sign is
+/// exact). Ties are real ties, not artifacts of the division.
+/// A decimal tick like 0.01 has no binary value; for those, see decimal.hpp.
+inline double round_to(double x, double m, rounding mode) noexcept {
+    double lo = std::floor(x / m); // off by at most one
+    lo -= std::fma(-lo, m, x) < 0;
+    lo += std::fma(-(lo + 1), m, x) >= 0;
+    // 2x - (2 lo + 1) m: twice the difference of the two distances
+    double d = std::fma(-(2 * lo + 1), m, x + x);
+    int cmp = (d > 0) - (d < 0);
+    bool exact = std::fma(-lo, m, x) == 0;
+    return (lo + detail::take_above(mode, x < 0, std::int64_t(lo) & 1, exact, cmp)) * m;
+}
@@ -0,0 +1,134 @@
+#include "round.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <vector>
+
+constexpr int imax = std::numeric_limits<int>::max();
+constexpr int imin = std::numeric_limits<int>::min();
+
+// The buffer-size bug: round_up(INT_MAX - 3, 64) wraps to a negative size
+static_assert(!checked_round_up(imax - 3, 64));
+static_assert(*checked_round_up(imax - 64, 64) == imax - 63);
+static_assert(saturating_round_up(imax - 3, 64) == imax / 64 * 64);
+static_assert(!checked_round_dn(imin + 1, 7));
+static_assert(saturating_round_dn(imin + 1, 7) == imin / 7 * 7);
+static_assert(*checked_round_dn(imin, 64) == imin);
+// Closest only fails if the nearer multiple is out of range
+static_assert(*checked_round_closest(imax, 3) == imax / 3 * 3);
+static_assert(!checked_round_closest(imax, 1 << 30));
+static_assert(*checked_round_closest(imax - (1 << 29) - 1, 1 << 30) == 1 << 30);
+static_assert(*checked_round_up(-7, divisor<int>{3}) == -6);
+static_assert(*checked_round_closest(-15, 10) == -10);
+
+/// Round every element up to a multiple of m, saturating the ones that
+/// don't fit. Returns how many saturated. The loop has no branches:
+/// the overflow flags are summed, not tested.
+template <class T>
+std::size_t saturating_round_up(std::span<const T> in, std::span<T> out,
+                                const divisor<T>& m) {
+    const T top = std::numeric_limits<T>::max() / m * m.value();
+    std::size_t n = std::min(in.size(), out.size());
+    std::size_t saturated = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        T r;
+        bool over = round_up_overflow(in[i], m, &r);
+        out[i] = over ? top : r;
+        saturated += over;
+    }
+    return saturated;
+}
+
+/// The same, all or nothing: false if any element overflowed
+template <class T>
+bool checked_round_up(std::span<const T> in, std::span<T> out, const divisor<T>& m) {
+    std::size_t n = std::min(in.size(), out.size());
+    bool any = false;
+    for (std::size_t i = 0; i < n; ++i) {
+        any |= round_up_overflow(in[i], m, &out[i]);
+    }
+    return !any;
+}
+
+template <class T>
+bool check(std::mt19937_64& gen) {
+    constexpr T max = std::numeric_limits<T>::max();
+    constexpr T min = std::numeric_limits<T>::min();
+    for (T m : {T(1), T(2), T(3), T(7), T(64), T(100), T(1) << 20, max / 3, max}) {
+        divisor<T> d{m};
+        std::vector<T> ns;
+        for (int i = 0; i < 100'000; ++i) {
+            ns.push_back(T(gen()));
+        }
+        for (T n : {T(0), T(1), T(-1), m, T(-m), max, min, T(max - m), T(min + m),
+                    T(max - m + 1), T(min + m - 1)}) {
+            ns.push_back(n);
+        }
+        using W = __int128;
+        for (T n : ns) {
+            // Reference: floor and ceiling in a wider type
+            W fl = W(n) / m - (W(n) % m < 0);
+            W lo = fl * m, hi = lo + (W(n) % m != 0) * W(m);
+            W cl = (W(n) - lo < hi - W(n)) ? lo : hi;
+            auto fits = [](W v) { return v >= W(min) && v <= W(max); };
+            auto same = [&](std::optional<T> got, W want) {
+                return fits(want) ? got && W(*got) == want : !got;
+            };
+            if (!same(checked_round_up(n, m), hi) || !same(checked_round_dn(n, m), lo) ||
+                !same(checked_round_closest(n, m), cl) ||
+                !same(checked_round_up(n, d), hi) || !same(checked_round_dn(n, d), lo) ||
+                !same(checked_round_closest(n, d), cl)) {
+                std::cout << "MISMATCH: n = " << n << ", m = " << m << '\n';
+                return false;
+            }
+            if (fits(hi) && fits(lo) && fits(cl) &&
+                (saturating_round_up(n, m) != round_up(n, m) ||
+                 saturating_round_dn(n, m) != round_dn(n, m) ||
+                 saturating_round_closest(n, m) != round_closest(n, m))) {
+                std::cout << "SATURATING MISMATCH: n = " << n << ", m = " << m << '\n';
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    std::mt19937_64 gen{63};
+    bool ok = check<std::int32_t>(gen) && check<std::int64_t>(gen);
+    std::cout << (ok ? "checked == exact result, when representable\n" : "");
+
+    // Requested sizes; a hostile one joins them after the baseline
+    std::vector<std::int64_t> sizes(20'000'000), out(sizes.size());
+    for (auto& s : sizes) {
+        s = std::int64_t(gen() % 1'000'000);
+    }
+    volatile std::int64_t page_v = 4096;
+    divisor<std::int64_t> page{page_v};
+
+    using ms = std::chrono::duration<double, std::milli>;
+    auto t0 = std::chrono::steady_clock::now();
+    // Unchecked, for the baseline: only on sizes known to fit, since
+    // round_up on a hostile one would overflow, which is undefined
+    for (std::size_t i = 0; i < sizes.size(); ++i) {
+        out[i] = round_up(sizes[i], page);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << "round_up:            " << ms(t1 - t0).count() << " ms\n";
+
+    sizes[12345] = std::numeric_limits<std::int64_t>::max() - 5;
+    t0 = std::chrono::steady_clock::now();
+    auto saturated = saturating_round_up<std::int64_t>(sizes, out, page);
+    t1 = std::chrono::steady_clock::now();
+    bool all = checked_round_up<std::int64_t>(sizes, out, page);
+    auto t2 = std::chrono::steady_clock::now();
+    std::cout << "saturating_round_up: " << ms(t1 - t0).count() << " ms, "
+              << saturated << " saturated\n"
+              << "checked_round_up:    " << ms(t2 - t1).count() << " ms, "
+              << (all ? "all fit" : "overflow detected") << '\n';
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,88 @@
+#include "round.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+// Everything is constexpr, so the edge cases can be checked by the compiler
+static_assert(round_up<64>(1) == 64);
+static_assert(round_up<64>(-1) == 0);
+static_assert(round_dn<64>(-1) == -64);
+static_assert(round_closest<64>(32) == 64);
+static_assert(round_closest<64>(-32) == 0);
+static_assert(round_closest<64>(-33) == -64);
+static_assert(round_up<64>(std::numeric_limits<int>::max() - 63) ==
+              std::numeric_limits<int>::max() - 63); // no overflow
+static_assert(round_up<10>(17) == 20);
+static_assert(round_dn<10>(-17) == -20);
+static_assert(round_closest<10>(-15) == -10);
+static_assert(round_up<4096>(std::uint64_t(1)) == 4096);
+static_assert(-7 / divisor<int>{3} == -2);
+static_assert(std::numeric_limits<std::int64_t>::min() / divisor<std::int64_t>{7} ==
+              std::numeric_limits<std::int64_t>::min() / 7);
+
+template <auto M, class T>
+bool check(const std::vector<T>& ns) {
+    constexpr T max = std::numeric_limits<T>::max();
+    constexpr T min = std::numeric_limits<T>::min();
+    divisor<T> d{T(M)};
+    for (T n : ns) {
+        if (n > max - T(M) || n < min + T(M)) {
+            continue; // some result is not representable
+        }
+        T up = round_up(n, T(M)), dn = round_dn(n, T(M)), cl = round_closest(n, T(M));
+        if (round_up<M>(n) != up || round_dn<M>(n) != dn || round_closest<M>(n) != cl ||
+            round_up(n, d) != up || round_dn(n, d) != dn || round_closest(n, d) != cl) {
+            std::cout << "MISMATCH: n = " << n << ", M = " << M << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class T>
+bool check_all(std::mt19937_64& gen) {
+    std::vector<T> ns;
+    for (int i = 0; i < 1'000'000; ++i) {
+        ns.push_back(T(gen()));
+        ns.push_back(T(gen() % 20000) - 10000);
+    }
+    ns.push_back(std::numeric_limits<T>::max());
+    ns.push_back(std::numeric_limits<T>::min());
+    return check<1>(ns) && check<2>(ns) && check<3>(ns) && check<5>(ns) &&
+           check<7>(ns) && check<10>(ns) && check<64>(ns) && check<100>(ns) &&
+           check<4096>(ns) && check<1000003>(ns);
+}
+
+int main() {
+    std::mt19937_64 gen{62};
+    bool ok = check_all<std::int32_t>(gen) && check_all<std::int64_t>(gen);
+    std::cout << (ok ? "round_up<M>, divisor<T> == round_up(n, m)\n" : "");
+
+    std::vector<std::int64_t> sizes(20'000'000);
+    for (auto& s : sizes) {
+        s = std::int64_t(gen() % 1'000'000);
+    }
+    volatile std::int64_t m_v = 100;
+    std::int64_t m = m_v;
+    divisor<std::int64_t> d{m};
+
+    auto time = [&](const char* name, auto f) {
+        std::int64_t acc = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        for (auto s : sizes) {
+            acc += f(s);
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        std::cout << name << ": "
+                  << std::chrono::duration<double, std::milli>(t1 - t0).count()
+                  << " ms (" << acc << ")\n";
+    };
+    time("round_up(n, m)     ", [&](std::int64_t n) { return round_up(n, m); });
+    time("round_up(n, d)     ", [&](std::int64_t n) { return round_up(n, d); });
+    time("round_up<100>(n)   ", [&](std::int64_t n) { return round_up<100>(n); });
+    time("round_up<64>(n)    ", [&](std::int64_t n) { return round_up<64>(n); });
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,321 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Vector arguments of inlined helpers; there is no ABI to keep stable here
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+// GCC/Clang vector extensions: `a + b` on these is one packed instruction
+// (addpd, vpaddd, ...), for whatever instruction set the function targets.
+template <class T, std::size_t Bytes>
+using vec_t [[gnu::vector_size(Bytes)]] = T;
+
+namespace ops {
+
+// `map` turns one element from each input into a term, `combine` folds terms.
+// Both work on scalars and on vectors alike.
+
+struct sum {
+    static constexpr int arity = 1;
+    template <class T>
+    static constexpr T identity = T(0);
+    static auto map(auto x) {
+        return x;
+    }
+    static auto combine(auto a, auto b) {
+        return a + b;
+    }
+};
+
+struct sum_sq {
+    static constexpr int arity = 1;
+    template <class T>
+    static constexpr T identity = T(0);
+    static auto map(auto x) {
+        return x * x;
+    }
+    static auto combine(auto a, auto b) {
+        return a + b;
+    }
+};
+
+struct dot {
+    static constexpr int arity = 2;
+    template <class T>
+    static constexpr T identity = T(0);
+    static auto map(auto x, auto y) {
+        return x * y;
+    }
+    static auto combine(auto a, auto b) {
+        return a + b;
+    }
+};
+
+struct min {
+    static constexpr int arity = 1;
+    template <class T>
+    static constexpr T identity = std::numeric_limits<T>::has_infinity
+                                      ? std::numeric_limits<T>::infinity()
+                                      : std::numeric_limits<T>::max();
+    static auto map(auto x) {
+        return x;
+    }
+    static auto combine(auto a, auto b) {
+        return a < b ? a : b; // on vectors: compare + blend, or vminpd
+    }
+};
+
+struct max {
+    static constexpr int arity = 1;
+    template <class T>
+    static constexpr T identity = std::numeric_limits<T>::has_infinity
+                                      ? -std::numeric_limits<T>::infinity()
+                                      : std::numeric_limits<T>::lowest();
+    static auto map(auto x) {
+        return x;
+    }
+    static auto combine(auto a, auto b) {
+        return a > b ? a : b;
+    }
+};
+
+} // namespace ops
+
+namespace detail {
+
+template <class V, class T>
+[[gnu::always_inline]] inline V load(const T* p) {
+    V v;
+    std::memcpy(&v, p, sizeof(V)); // unaligned load
+    return v;
+}
+
+template <class Op, class T, class V>
+[[gnu::always_inline]] inline V step(V acc, const T* a, const T* b, std::size_t i) {
+    if constexpr (Op::arity == 1) {
+        return Op::combine(acc, Op::map(load<V>(a + i)));
+    } else {
+        return Op::combine(acc, Op::map(load<V>(a + i), load<V>(b + i)));
+    }
+}
+
+/// `Acc` independent vector accumulators, so that the loop is bound by
+/// throughput (two adds per cycle) rather than by add latency (four cycles).
+/// Always inlined, so it is compiled for the instruction set of its caller.
+template <class Op, class T, std::size_t Bytes, std::size_t Acc>
+[[gnu::always_inline]] inline T kernel(std::size_t n, const T* a, const T* b) {
+    using V = vec_t<T, Bytes>;
+    constexpr std::size_t W = Bytes / sizeof(T);
+    const T id = Op::template identity<T>;
+
+    V acc[Acc];
+    for (auto& v : acc) {
+        v = V{} + id; // broadcast
+    }
+    std::size_t i = 0;
+    for (; i + Acc * W <= n; i += Acc * W) {
+        for (std::size_t k = 0; k < Acc; ++k) {
+            acc[k] = step<Op>(acc[k], a, b, i + k * W);
+        }
+    }
+    for (; i + W <= n; i += W) {
+        acc[0] = step<Op>(acc[0], a, b, i);
+    }
+    for (std::size_t w = Acc / 2; w > 0; w /= 2) {
+        for (std::size_t k = 0; k < w; ++k) {
+            acc[k] = Op::combine(acc[k], acc[k + w]);
+        }
+    }
+
+    T r = id;
+    for (std::size_t j = 0; j < W; ++j) {
+        r = Op::combine(r, acc[0][j]);
+    }
+    for (; i < n; ++i) {
+        if constexpr (Op::arity == 1) {
+            r = Op::combine(r, Op::map(a[i]));
+        } else {
+            r = Op::combine(r, Op::map(a[i], b[i]));
+        }
+    }
+    return r;
+}
+
+// One entry point per instruction set
+
+template <class Op, class T>
+T kernel_sse2(std::size_t n, const T* a, const T* b) {
+    return kernel<Op, T, 16, 8>(n, a, b);
+}
+
+template <class Op, class T>
+[[gnu::target("avx2")]] T kernel_avx2(std::size_t n, const T* a, const T* b) {
+    return kernel<Op, T, 32, 8>(n, a, b);
+}
+
+template <class Op, class T>
+[[gnu::target("avx512f,avx512dq")]] T kernel_avx512(std::size_t n, const T* a,
+                                                     const T* b) {
+    return kernel<Op, T, 64, 4>(n, a, b);
+}
+
+template <class Op, class T>
+using kernel_fn = T (*)(std::size_t, const T*, const T*);
+
+template <class Op, class T>
+kernel_fn<Op, T> select() noexcept {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return &kernel_avx512<Op, T>;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return &kernel_avx2<Op, T>;
+    }
+    return &kernel_sse2<Op, T>;
+}
+
+template <class Op, class T>
+T dispatch(std::size_t n, const T* a, const T* b = nullptr) {
+    static const kernel_fn<Op, T> fn = select<Op, T>(); // once per (Op, T)
+    return fn(n, a, b);
+}
+
+/// For sums: signed overflow is undefined, in vectors as in scalars, so
+/// signed integers are added in the unsigned type of the same width
+template <class Op, class T>
+T dispatch_wrapping(std::size_t n, const T* a, const T* b = nullptr) {
+    if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        using U = std::make_unsigned_t<T>;
+        // Signed and unsigned variants of a type may alias
+        return T(dispatch<Op>(n, reinterpret_cast<const U*>(a),
+                              reinterpret_cast<const U*>(b)));
+    } else {
+        return dispatch<Op>(n, a, b);
+    }
+}
+
+} // namespace detail
+
+// Integer sums wrap around (modulo 2^bits), where a plain loop or
+// std::reduce on a signed T would overflow: undefined behaviour.
+// min/max of an empty span is the identity (+inf / numeric_limits::max()).
+// Floating-point results differ from a left fold in the last bits.
+
+template <class T>
+T sum(std::span<const T> xs) {
+    return detail::dispatch_wrapping<ops::sum>(xs.size(), xs.data());
+}
+
+template <class T>
+T sum_sq(std::span<const T> xs) {
+    return detail::dispatch_wrapping<ops::sum_sq>(xs.size(), xs.data());
+}
+
+template <class T>
+T min(std::span<const T> xs) {
+    return detail::dispatch<ops::min>(xs.size(), xs.data());
+}
+
+template <class T>
+T max(std::span<const T> xs) {
+    return detail::dispatch<ops::max>(xs.size(), xs.data());
+}
+
+/// Over the common prefix of `xs` and `ys`
+template <class T>
+T dot(std::span<const T> xs, std::span<const T> ys) {
+    return detail::dispatch_wrapping<ops::dot>(std::min(xs.size(), ys.size()), xs.data(),
+                                               ys.data());
+}
+
+const char* isa() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) {
+        return "avx512";
+    }
+    return __builtin_cpu_supports("avx2") ? "avx2" : "sse2";
+}
+
+template <class T>
+void run(const char* type) {
+    std::mt19937_64 gen{1};
+    std::vector<T> xs(20'000'001), ys(xs.size());
+    for (std::size_t i = 0; i < xs.size(); ++i) {
+        if constexpr (std::is_floating_point_v<T>) {
+            xs[i] = T(std::uniform_real_distribution<double>{-1, 1}(gen));
+            ys[i] = T(std::uniform_real_distribution<double>{-1, 1}(gen));
+        } else {
+            // Small enough that the naive loops can't overflow an int32:
+            // 20M squares of at most 100
+            xs[i] = T(gen() % 21) - 10;
+            ys[i] = T(gen() % 21) - 10;
+        }
+    }
+    std::span<const T> a{xs}, b{ys};
+    // Scalar loops, one accumulator; floats in double so that they can check
+    using S = std::conditional_t<std::is_same_v<T, float>, double, T>;
+
+    auto check = [&](const char* name, auto fast, auto naive) {
+        auto t0 = std::chrono::steady_clock::now();
+        T f = fast();
+        auto t1 = std::chrono::steady_clock::now();
+        T s = naive();
+        auto t2 = std::chrono::steady_clock::now();
+        using ms = std::chrono::duration<double, std::milli>;
+        bool ok = std::is_integral_v<T>
+                      ? f == s
+                      : std::abs(double(f) - double(s)) <=
+                            1e-3 * std::max(1.0, std::abs(double(s)));
+        std::cout << type << ' ' << name << ": " << ms(t1 - t0).count()
+                  << " ms vs " << ms(t2 - t1).count() << " ms naive"
+                  << (ok ? "" : "  MISMATCH") << '\n';
+    };
+
+    check("sum   ", [&] { return sum(a); }, [&] {
+        S s = 0;
+        for (T x : xs) s += x;
+        return T(s);
+    });
+    check("sum_sq", [&] { return sum_sq(a); }, [&] {
+        S s = 0;
+        for (T x : xs) s += S(x) * x;
+        return T(s);
+    });
+    check("dot   ", [&] { return dot(a, b); }, [&] {
+        S s = 0;
+        for (std::size_t i = 0; i < xs.size(); ++i) s += S(xs[i]) * ys[i];
+        return T(s);
+    });
+    check("min   ", [&] { return min(a); }, [&] {
+        T s = xs[0];
+        for (T x : xs) s = std::min(s, x);
+        return s;
+    });
+    check("max   ", [&] { return max(a); }, [&] {
+        T s = xs[0];
+        for (T x : xs) s = std::max(s, x);
+        return s;
+    });
+}
+
+int main() {
+    std::cout << "dispatching to " << isa() << '\n';
+    run<float>("float  ");
+    run<double>("double ");
+    run<std::int32_t>("int32  ");
+    run<std::int64_t>("int64  ");
+
+    std::vector<std::int32_t> big(1001, std::numeric_limits<std::int32_t>::max());
+    auto wrapped = std::int32_t(std::uint32_t(big[0]) * std::uint32_t(big.size()));
+    std::cout << "int32 overflow: "
+              << (sum(std::span<const std::int32_t>{big}) == wrapped ? "wraps" : "MISMATCH")
+              << '\n';
+}
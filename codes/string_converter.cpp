@@ -0,0 +1,167 @@
+#include "string_converter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class Side { buy, sell };
+
+// A converter for a user type: specialize the class, not from_string
+template <>
+struct string_converter<Side> {
+    scan_error scan(std::string_view s, Side& out) const noexcept {
+        if (s == "B") {
+            out = Side::buy;
+        } else if (s == "S") {
+            out = Side::sell;
+        } else {
+            return {std::errc::invalid_argument, 0};
+        }
+        return {};
+    }
+};
+
+struct Order {
+    std::int64_t id;
+    Side side;
+    double px;
+    std::uint32_t qty;
+    std::string_view sym;
+};
+
+struct Tick {
+    std::uint16_t venue;
+    std::int32_t px;
+};
+template <>
+inline constexpr char field_separator<Tick> = '|';
+
+template <class F>
+void bench(const char* name, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << name << ": "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+}
+
+int main() {
+    bool ok = true;
+    auto check = [&](bool c, const char* what) {
+        if (!c) {
+            std::cout << "FAILED: " << what << '\n';
+            ok = false;
+        }
+    };
+
+    check(from_string<int>("42") == 42, "42");
+    check(from_string<int>("-2147483648") == INT32_MIN, "INT_MIN");
+    check(!from_string<int>("2147483648"), "int overflow");
+    check(from_string<std::uint64_t>("18446744073709551615") == UINT64_MAX, "u64 max");
+    check(!from_string<std::uint64_t>("18446744073709551616"), "u64 overflow");
+    check(from_string<std::int64_t>("000000000000000000000012") == 12, "leading zeros");
+    check(!from_string<unsigned>("-1"), "negative unsigned");
+    check(!from_string<int>(""), "empty");
+    check(!from_string<int>("-"), "sign only");
+    check(!from_string<int>("+1"), "plus, as from_chars");
+    check(from_string<std::int8_t>("-128") == -128, "i8");
+    check(from_string<double>("1e-3") == 1e-3, "double");
+    check(from_string<bool>("true") == true && from_string<bool>("0") == false, "bool");
+
+    int n = 0;
+    scan_error e = from_string("12345x78", n);
+    check(e.ec == std::errc::invalid_argument && e.pos == 5, "position of x");
+    e = from_string("99999999999", n);
+    check(e.ec == std::errc::result_out_of_range, "out of range");
+
+    auto o = from_string<Order>("7,S,101.25,300,ABC");
+    check(o && o->id == 7 && o->side == Side::sell && o->px == 101.25 && o->qty == 300 &&
+              o->sym == "ABC",
+          "Order");
+    Order bad;
+    e = from_string("7,S,101.25,3x0,ABC", bad);
+    check(e.ec == std::errc::invalid_argument && e.pos == 12, "Order: bad qty");
+    e = from_string("7,S", bad);
+    check(e && e.pos == 3, "Order: too few fields");
+    check(from_string<Tick>("3|-125")->px == -125, "separator");
+    check(!from_string<Tick>("3|1|2"), "too many fields");
+
+    // Each digit count, against from_chars
+    std::mt19937_64 rng(1);
+    for (int i = 0; i < 100000; ++i) {
+        std::int64_t x = std::int64_t(rng()) >> (rng() % 64);
+        auto s = std::to_string(x);
+        check(from_string<std::int64_t>(s) == x, "random int64");
+        if (!ok) {
+            std::cout << s << '\n';
+            break;
+        }
+    }
+
+    // fast_float against from_chars: signs, with and without a dot, up to
+    // one digit past its limit, so both it and the fallback are reached
+    auto random_floats = [&]<class T>(const char* what) {
+        constexpr int max_digits = std::min(std::numeric_limits<T>::digits10, 15);
+        int fast = 0;
+        for (int i = 0; i < 200000 && ok; ++i) {
+            std::string s = rng() % 2 ? "-" : "";
+            int digits = 1 + int(rng() % (max_digits + 1));
+            int dot = rng() % 4 ? int(rng() % digits) : 0; // 0: no dot
+            for (int k = 0; k < digits; ++k) {
+                s += k == dot && dot > 0 ? "." : "";
+                s += char('0' + rng() % 10);
+            }
+            T expect = 0, x = 0;
+            std::from_chars(s.data(), s.data() + s.size(), expect);
+            auto same = [&] { return x == expect && std::signbit(x) == std::signbit(expect); };
+            if (convert_detail::fast_float(s, x)) {
+                ++fast;
+                check(same(), what);
+            }
+            check(!from_string(s, x) && same(), what);
+            if (!ok) {
+                std::cout << s << '\n';
+            }
+        }
+        check(fast > 100000, what);
+    };
+    random_floats.operator()<double>("random double");
+    random_floats.operator()<float>("random float");
+
+    // 10M integer fields, 1 to 10 digits, in one buffer as a CSV would be
+    constexpr int count = 10'000'000;
+    std::string text;
+    std::vector<std::size_t> ends;
+    for (int i = 0; i < count; ++i) {
+        text += std::to_string(std::uint32_t(rng()) >> (rng() % 32));
+        ends.push_back(text.size());
+    }
+    std::vector<std::string_view> cells;
+    for (std::size_t i = 0, b = 0; i < ends.size(); b = ends[i++]) {
+        cells.emplace_back(text.data() + b, ends[i] - b);
+    }
+    std::uint64_t sum1 = 0, sum2 = 0;
+    bench("std::from_chars          ", [&] {
+        for (auto s : cells) {
+            std::uint32_t x = 0;
+            std::from_chars(s.data(), s.data() + s.size(), x);
+            sum1 += x;
+        }
+    });
+    bench("string_converter<uint32_t>", [&] {
+        for (auto s : cells) {
+            std::uint32_t x = 0;
+            from_string(s, x);
+            sum2 += x;
+        }
+    });
+    check(sum1 == sum2, "same sums");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,289 @@
+#pragma once
+
+// The string_converter customization point from "Template Best
+// Practices", built out for bulk parsing:
+//
+//   auto n = from_string<int>("42");             // std::optional<int>
+//   if (auto e = from_string("4x", n)) { ... }   // e.ec, e.pos
+//
+//   struct Order { std::int64_t id; double px; std::string_view sym; };
+//   auto o = from_string<Order>("7,101.25,ABC"); // field by field
+//
+// No exceptions: scan() reports errors as std::from_chars does, plus the
+// offset of the failure. The whole input must be consumed: "12x" is an
+// error, where from_chars would stop at the 'x'.
+//
+// Integers of up to digits10 digits are parsed eight digits at a time in
+// a 64-bit register, and so are plain decimals ("-12.5") of up to
+// digits10 digits; anything longer, or with an exponent, or malformed,
+// goes to std::from_chars, which has the exact rounding and error rules.
+//
+// Specialize string_converter for your own types (not from_string):
+//
+//   template <>
+//   struct string_converter<Side> {
+//       scan_error scan(std::string_view s, Side& out) const noexcept;
+//   };
+
+#include "aggregate.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+
+/// Success is a default-constructed ec; `pos` is the offset in the input
+struct scan_error {
+    std::errc ec{};
+    std::size_t pos = 0;
+
+    explicit constexpr operator bool() const noexcept {
+        return ec != std::errc{};
+    }
+};
+
+/// Primary template: undefined, so a type without a converter is an error
+template <class T>
+struct string_converter;
+
+template <class T>
+concept scannable = requires(const string_converter<T>& c, std::string_view s, T& x) {
+    { c.scan(s, x) } -> std::same_as<scan_error>;
+};
+
+namespace convert_detail {
+
+inline scan_error from_chars_result(std::string_view s, std::from_chars_result r) noexcept {
+    if (r.ec != std::errc{}) {
+        return {r.ec, std::size_t(r.ptr - s.data())};
+    }
+    if (r.ptr != s.data() + s.size()) {
+        return {std::errc::invalid_argument, std::size_t(r.ptr - s.data())};
+    }
+    return {};
+}
+
+template <class T>
+scan_error scan_from_chars(std::string_view s, T& out) noexcept {
+    return from_chars_result(s, std::from_chars(s.data(), s.data() + s.size(), out));
+}
+
+/// v holds eight chars, the first in the low byte. No branches: `out`
+/// is written either way, and is garbage unless all eight are digits.
+inline bool parse8(std::uint64_t v, std::uint64_t& out) noexcept {
+    static_assert(std::endian::native == std::endian::little);
+    // Each byte is 0x30..0x39: high nibble 3, and adding 6 doesn't carry
+    bool ok = ((v & 0xF0F0F0F0F0F0F0F0) |
+               (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+    // Combine neighbours: 8 digits -> 4 pairs -> 2 quads -> 1
+    v = (v & 0x0F0F0F0F0F0F0F0F) * (10 * 256 + 1) >> 8;
+    v = (v & 0x00FF00FF00FF00FF) * (100 * 65536 + 1) >> 16;
+    out = (v & 0x0000FFFF0000FFFF) * (10000 * (std::uint64_t{1} << 32) + 1) >> 32;
+    return ok;
+}
+
+/// The eight ASCII digits at p; false if any isn't one
+inline bool parse8(const char* p, std::uint64_t& out) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, 8);
+    return parse8(v, out);
+}
+
+/// Read in place of input that isn't there, so the loads below can be
+/// selected rather than branched around
+inline constexpr char zeros[8] = {'0', '0', '0', '0', '0', '0', '0', '0'};
+
+/// The k (1 to 8) chars at p as parse8 takes them, left-padded with '0'.
+/// Reads only [p, p + k): two overlapping loads, or three bytes.
+inline std::uint64_t load_padded(const char* p, std::size_t k) noexcept {
+    bool wide = k >= 4;
+    const char* q = wide ? p : zeros;
+    std::size_t off = wide ? k - 4 : 0;
+    std::uint32_t lo, hi;
+    std::memcpy(&lo, q, 4);
+    std::memcpy(&hi, q + off, 4);
+    std::uint64_t w4 = lo | std::uint64_t(hi) << (8 * off); // the overlap agrees
+    std::uint64_t w3 = std::uint64_t(std::uint8_t(p[0])) |
+                       std::uint64_t(std::uint8_t(p[k / 2])) << (8 * (k / 2)) |
+                       std::uint64_t(std::uint8_t(p[k - 1])) << (8 * (k - 1));
+    std::uint64_t w = wide ? w4 : w3;
+    // Two shifts: k = 8 would shift by 64
+    return w << (8 * (8 - k)) | 0x3030303030303030 >> (8 * k - 1) >> 1;
+}
+
+/// 1 to MaxDigits digits: a chunk of 1 to 8, then chunks of 8. The
+/// chunk count is fixed by MaxDigits; missing chunks read `zeros`.
+template <std::size_t MaxDigits>
+bool parse_digits(std::string_view s, std::uint64_t& out) noexcept {
+    static_assert(MaxDigits <= 19);
+    std::size_t full = (s.size() - 1) / 8;
+    std::size_t first = s.size() - full * 8;
+    const char* p = s.data();
+    std::uint64_t value, chunk;
+    bool ok = parse8(load_padded(p, first), value);
+    p += first;
+    for (std::size_t c = 0; c < (MaxDigits - 1) / 8; ++c) {
+        bool more = c < full;
+        ok &= parse8(more ? p : zeros, chunk);
+        value = more ? value * 100000000 + chunk : value;
+        p += more ? 8 : 0;
+    }
+    out = value;
+    return ok;
+}
+
+/// [-]digits, at most digits10 of them, so the value always fits.
+/// False for anything else, with `out` unspecified: ask from_chars.
+template <std::integral T>
+bool fast_integer(std::string_view s, T& out) noexcept {
+    constexpr std::size_t max_digits = std::numeric_limits<T>::digits10;
+    bool neg = std::is_signed_v<T> && s.starts_with('-');
+    std::string_view digits = s.substr(neg);
+    bool fits = digits.size() - 1 < max_digits; // and not empty
+    std::uint64_t v;
+    bool ok = parse_digits<max_digits>(fits ? digits : std::string_view(zeros, 1), v);
+    out = T(neg ? 0 - v : v);
+    return fits & ok;
+}
+
+inline constexpr double pow10[] = {1e0, 1e1, 1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                   1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15};
+
+/// [-]digits[.digits], at most digits10 digits in all, no exponent.
+/// Then the digits and the power of ten are both exact in T, and one
+/// correctly rounded division gives what from_chars would.
+template <std::floating_point T>
+bool fast_float(std::string_view s, T& out) noexcept {
+    constexpr std::size_t max_digits = std::min(std::numeric_limits<T>::digits10, 15);
+    bool neg = s.starts_with('-');
+    s.remove_prefix(neg);
+    std::size_t dot = std::min(s.find('.'), s.size());
+    std::string_view ip = s.substr(0, dot);
+    std::string_view fp = s.substr(std::min(dot + 1, s.size()));
+    bool fits = ip.size() - 1 < max_digits && fp.size() <= max_digits - ip.size() &&
+                (fp.size() > 0 || dot == s.size()); // not "5."
+    std::size_t scale = fits ? fp.size() : 0;
+    std::uint64_t a, b;
+    bool ok = parse_digits<max_digits>(fits ? ip : std::string_view(zeros, 1), a) &
+              parse_digits<max_digits>(scale > 0 ? fp : std::string_view(zeros, 1), b);
+    T x = T(a * std::uint64_t(pow10[scale]) + b) / T(pow10[scale]);
+    out = neg ? -x : x;
+    return fits & ok;
+}
+
+} // namespace convert_detail
+
+template <std::integral T>
+    requires(!std::same_as<T, bool>)
+struct string_converter<T> {
+    scan_error scan(std::string_view s, T& out) const noexcept {
+        if (convert_detail::fast_integer(s, out)) {
+            return {};
+        }
+        return convert_detail::scan_from_chars(s, out);
+    }
+};
+
+template <std::floating_point T>
+struct string_converter<T> {
+    scan_error scan(std::string_view s, T& out) const noexcept {
+        if (convert_detail::fast_float(s, out)) {
+            return {};
+        }
+        return convert_detail::scan_from_chars(s, out);
+    }
+};
+
+/// "true", "false", "1" or "0"
+template <>
+struct string_converter<bool> {
+    scan_error scan(std::string_view s, bool& out) const noexcept {
+        if (s == "true" || s == "1") {
+            out = true;
+        } else if (s == "false" || s == "0") {
+            out = false;
+        } else {
+            return {std::errc::invalid_argument, 0};
+        }
+        return {};
+    }
+};
+
+/// Points into the input: valid as long as the input is
+template <>
+struct string_converter<std::string_view> {
+    scan_error scan(std::string_view s, std::string_view& out) const noexcept {
+        out = s;
+        return {};
+    }
+};
+
+template <>
+struct string_converter<std::string> {
+    scan_error scan(std::string_view s, std::string& out) const {
+        out.assign(s);
+        return {};
+    }
+};
+
+/// Between the fields of an aggregate; specialize for another
+template <class T>
+inline constexpr char field_separator = ',';
+
+/// An aggregate whose fields all have converters, as "f0,f1,...".
+/// The last field takes the rest of the input.
+template <class T>
+    requires std::is_aggregate_v<T> && (!std::is_array_v<T>) &&
+             std::is_default_constructible_v<T>
+struct string_converter<T> {
+    scan_error scan(std::string_view s, T& out) const {
+        return std::apply(
+            [&](auto&... fields) {
+                scan_error e;
+                std::size_t pos = 0;
+                std::size_t i = 0;
+                // Stops at the first error: && short-circuits the fold
+                ((e = scan_field(s, pos, ++i == sizeof...(fields), fields), !e) && ...);
+                return e;
+            },
+            tie_as_tuple(out));
+    }
+
+private:
+    template <scannable F>
+    static scan_error scan_field(std::string_view s, std::size_t& pos, bool last, F& f) {
+        std::size_t end = last ? s.size() : s.find(field_separator<T>, pos);
+        if (end == std::string_view::npos) {
+            return {std::errc::invalid_argument, s.size()}; // too few fields
+        }
+        scan_error e = string_converter<F>{}.scan(s.substr(pos, end - pos), f);
+        e.pos += pos;
+        pos = end + 1;
+        return e;
+    }
+};
+
+/// Parse `s` into `out`; on error, `out` may be partly written
+template <scannable T>
+scan_error from_string(std::string_view s, T& out) {
+    return string_converter<T>{}.scan(s, out);
+}
+
+template <scannable T>
+std::optional<T> from_string(std::string_view s) {
+    T x{};
+    if (from_string(s, x)) {
+        return std::nullopt;
+    }
+    return x;
+}
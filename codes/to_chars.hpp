@@ -0,0 +1,337 @@
+#pragma once
+
+// Numbers to text without a std::string per element.
+//
+//   my::to_chars(buf, x)            digit-pair integer formatting, std::to_chars
+//                                   for floating point; returns the end
+//   v | my::views::to_chars         lazy: each iterator holds a small buffer,
+//                                   *it is a string_view into it
+//   my::ranges::to_chars_table(v)   eager: everything in one arena,
+//                                   a random-access range of string_views
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace my {
+
+namespace detail {
+
+inline constexpr char digit_pairs[201] = "00010203040506070809"
+                                         "10111213141516171819"
+                                         "20212223242526272829"
+                                         "30313233343536373839"
+                                         "40414243444546474849"
+                                         "50515253545556575859"
+                                         "60616263646566676869"
+                                         "70717273747576777879"
+                                         "80818283848586878889"
+                                         "90919293949596979899";
+
+constexpr int count_digits(std::uint64_t v) noexcept {
+    int n = 1;
+    for (;;) {
+        if (v < 10) {
+            return n;
+        }
+        if (v < 100) {
+            return n + 1;
+        }
+        if (v < 1000) {
+            return n + 2;
+        }
+        if (v < 10000) {
+            return n + 3;
+        }
+        v /= 10000;
+        n += 4;
+    }
+}
+
+/// Writes exactly count_digits(v) characters, two at a time from the end
+constexpr char* format_unsigned(char* out, std::uint64_t v) noexcept {
+    char* end = out + count_digits(v);
+    char* p = end;
+    while (v >= 100) {
+        auto i = v % 100 * 2;
+        v /= 100;
+        *--p = digit_pairs[i + 1];
+        *--p = digit_pairs[i];
+    }
+    if (v >= 10) {
+        *--p = digit_pairs[v * 2 + 1];
+        *--p = digit_pairs[v * 2];
+    } else {
+        *--p = char('0' + v);
+    }
+    return end;
+}
+
+} // namespace detail
+
+/// Buffer size that fits any value of T (shortest round-trip form for floats)
+template <class T>
+inline constexpr std::size_t max_chars =
+    std::is_floating_point_v<T>
+        ? 4 + std::numeric_limits<T>::max_digits10 + 2 + 4 // -d.ddd...e-ddd
+        : std::numeric_limits<T>::digits10 + 2;             // sign, digits
+
+template <class T>
+concept formattable_number = std::is_arithmetic_v<T> && !std::same_as<T, bool>;
+
+/// Format x at `out`, which has room for max_chars<T>; returns the end.
+/// Same text as std::to_chars(out, out + max_chars<T>, x).
+template <formattable_number T>
+constexpr char* to_chars(char* out, T x) noexcept {
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::to_chars(out, out + max_chars<T>, x).ptr;
+    } else if constexpr (std::is_signed_v<T>) {
+        auto u = std::uint64_t(x);
+        if (x < 0) {
+            *out++ = '-';
+            u = 0 - u; // also right for the minimum
+        }
+        return detail::format_unsigned(out, u);
+    } else {
+        return detail::format_unsigned(out, x);
+    }
+}
+
+/// Length of to_chars(out, x), for integers
+template <std::integral T>
+constexpr std::size_t chars_for(T x) noexcept {
+    if constexpr (std::is_signed_v<T>) {
+        auto u = std::uint64_t(x);
+        return x < 0 ? 1 + std::size_t(detail::count_digits(0 - u))
+                     : std::size_t(detail::count_digits(u));
+    } else {
+        return std::size_t(detail::count_digits(x));
+    }
+}
+
+namespace ranges {
+
+/// Lazy. Each iterator owns a max_chars buffer; *it formats into it and
+/// returns a view of it, valid until the iterator moves or dies.
+/// That makes it an input range, like views::istream, whatever V is.
+template <std::ranges::input_range V>
+    requires std::ranges::view<V> && formattable_number<std::ranges::range_value_t<V>>
+class to_chars_view : public std::ranges::view_interface<to_chars_view<V>> {
+    using T = std::ranges::range_value_t<V>;
+
+    V base_;
+
+    class iterator {
+        std::ranges::iterator_t<V> it_;
+        mutable char buf_[max_chars<T>];
+
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using value_type = std::string_view;
+        using difference_type = std::ranges::range_difference_t<V>;
+
+        iterator() = default;
+        explicit iterator(std::ranges::iterator_t<V> it) : it_(std::move(it)) {}
+
+        iterator(iterator&&) = default;
+        iterator& operator=(iterator&&) = default;
+
+        std::string_view operator*() const {
+            return {buf_, to_chars(buf_, T(*it_))};
+        }
+        iterator& operator++() {
+            ++it_;
+            return *this;
+        }
+        void operator++(int) {
+            ++it_;
+        }
+        friend bool operator==(const iterator& i, const std::ranges::sentinel_t<V>& s) {
+            return i.it_ == s;
+        }
+    };
+
+public:
+    to_chars_view() = default;
+    explicit to_chars_view(V base) : base_(std::move(base)) {}
+
+    iterator begin() {
+        return iterator{std::ranges::begin(base_)};
+    }
+    std::ranges::sentinel_t<V> end() {
+        return std::ranges::end(base_);
+    }
+    auto size()
+        requires std::ranges::sized_range<V>
+    {
+        return std::ranges::size(base_);
+    }
+};
+
+template <class R>
+to_chars_view(R&&) -> to_chars_view<std::views::all_t<R>>;
+
+/// Eager. Formats everything into one arena (one allocation for the text,
+/// one for the offsets), then indexes it; a container, not a view.
+/// For bulk export, the arena is also one joined string: `text()`.
+class to_chars_table {
+    std::unique_ptr<char[]> text_; // not zero-filled, unlike std::string
+    std::size_t capacity_ = 0;
+    std::size_t used_ = 0;
+    std::vector<std::size_t> ends_; // end offset of each element in text_
+
+    void grow(std::size_t capacity) {
+        auto bigger = std::make_unique_for_overwrite<char[]>(capacity);
+        if (used_ > 0) { // text_ is null at first, and memcpy mustn't see null
+            std::memcpy(bigger.get(), text_.get(), used_);
+        }
+        text_ = std::move(bigger);
+        capacity_ = capacity;
+    }
+
+public:
+    /// Elements are separated by `sep` in text() (not in the views)
+    template <std::ranges::input_range R>
+        requires formattable_number<std::ranges::range_value_t<R>>
+    explicit to_chars_table(R&& r, char sep = '\n') {
+        using T = std::ranges::range_value_t<R>;
+        // Integers: a cheap first pass gives the exact size
+        constexpr bool exact = std::integral<T> && std::ranges::forward_range<R>;
+        if constexpr (exact) {
+            std::size_t total = 0;
+            for (auto&& x : r) {
+                total += chars_for(T(x)) + 1;
+            }
+            grow(total);
+        }
+        if constexpr (std::ranges::sized_range<R>) {
+            ends_.reserve(std::ranges::size(r));
+        }
+        char* p = text_.get();
+        for (auto&& x : r) {
+            if constexpr (!exact) {
+                if (capacity_ - used_ < max_chars<T> + 1) {
+                    grow(std::max<std::size_t>(256, capacity_ * 2));
+                    p = text_.get() + used_;
+                }
+            }
+            p = to_chars(p, T(x));
+            ends_.push_back(std::size_t(p - text_.get()));
+            *p++ = sep;
+            used_ = std::size_t(p - text_.get());
+        }
+    }
+
+    std::size_t size() const noexcept {
+        return ends_.size();
+    }
+
+    std::string_view operator[](std::size_t i) const noexcept {
+        std::size_t first = i == 0 ? 0 : ends_[i - 1] + 1;
+        return {text_.get() + first, ends_[i] - first};
+    }
+
+    /// All elements, each followed by the separator
+    std::string_view text() const noexcept {
+        return {text_.get(), used_};
+    }
+
+    class iterator {
+        const to_chars_table* t_ = nullptr;
+        std::ptrdiff_t i_ = 0;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag; // yields prvalues
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        iterator(const to_chars_table* t, std::ptrdiff_t i) noexcept : t_(t), i_(i) {}
+
+        std::string_view operator*() const noexcept {
+            return (*t_)[std::size_t(i_)];
+        }
+        std::string_view operator[](difference_type n) const noexcept {
+            return (*t_)[std::size_t(i_ + n)];
+        }
+        iterator& operator++() noexcept {
+            ++i_;
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            return {t_, i_++};
+        }
+        iterator& operator--() noexcept {
+            --i_;
+            return *this;
+        }
+        iterator operator--(int) noexcept {
+            return {t_, i_--};
+        }
+        iterator& operator+=(difference_type n) noexcept {
+            i_ += n;
+            return *this;
+        }
+        iterator& operator-=(difference_type n) noexcept {
+            i_ -= n;
+            return *this;
+        }
+        friend iterator operator+(iterator it, difference_type n) noexcept {
+            return it += n;
+        }
+        friend iterator operator+(difference_type n, iterator it) noexcept {
+            return it += n;
+        }
+        friend iterator operator-(iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+        friend difference_type operator-(const iterator& a, const iterator& b) noexcept {
+            return a.i_ - b.i_;
+        }
+        friend bool operator==(const iterator& a, const iterator& b) noexcept {
+            return a.i_ == b.i_;
+        }
+        friend auto operator<=>(const iterator& a, const iterator& b) noexcept {
+            return a.i_ <=> b.i_;
+        }
+    };
+
+    iterator begin() const noexcept {
+        return {this, 0};
+    }
+    iterator end() const noexcept {
+        return {this, std::ptrdiff_t(size())};
+    }
+};
+
+} // namespace ranges
+
+namespace views {
+
+struct to_chars_fn {
+    template <std::ranges::viewable_range R>
+    auto operator()(R&& r) const {
+        return ranges::to_chars_view{std::forward<R>(r)};
+    }
+    template <std::ranges::viewable_range R>
+    friend auto operator|(R&& r, const to_chars_fn& self) {
+        return self(std::forward<R>(r));
+    }
+};
+
+inline constexpr to_chars_fn to_chars;
+
+} // namespace views
+
+} // namespace my
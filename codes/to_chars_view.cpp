@@ -0,0 +1,92 @@
+#include "to_chars.hpp"
+
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+template <class T>
+bool check(const std::vector<T>& xs) {
+    my::ranges::to_chars_table table{xs, ','};
+    std::size_t i = 0;
+    for (auto sv : xs | my::views::to_chars) {
+        char buf[64];
+        auto [end, ec] = std::to_chars(buf, buf + sizeof(buf), xs[i]);
+        std::string_view want{buf, end};
+        if (sv != want || table[i] != want) {
+            std::cout << "MISMATCH: " << want << " vs " << sv << '\n';
+            return false;
+        }
+        ++i;
+    }
+    return i == xs.size() && table.size() == xs.size();
+}
+
+template <class F>
+void bench(const char* name, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    auto bytes = f();
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << name << ": "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms ("
+              << bytes << " bytes)\n";
+}
+
+int main() {
+    std::mt19937_64 gen{66};
+    std::vector<std::int64_t> ints;
+    std::vector<std::uint32_t> small;
+    std::vector<double> doubles;
+    for (int i = 0; i < 100'000; ++i) {
+        ints.push_back(std::int64_t(gen()) >> (gen() % 64));
+        small.push_back(std::uint32_t(gen() % 1000));
+        doubles.push_back(std::uniform_real_distribution<double>{-1e6, 1e6}(gen));
+    }
+    for (auto x : {std::numeric_limits<std::int64_t>::min(),
+                   std::numeric_limits<std::int64_t>::max(), std::int64_t{0},
+                   std::int64_t{-1}, std::int64_t{10}, std::int64_t{99}}) {
+        ints.push_back(x);
+    }
+    bool ok = check(ints) && check(small) && check(doubles);
+    std::cout << (ok ? "same text as std::to_chars\n" : "");
+
+    // The post's example, without a string per element
+    std::vector<int> numbers{1, 1, 2, 3, 5};
+    for (std::string_view s : numbers | my::views::to_chars) {
+        std::cout << s << ' ';
+    }
+    std::cout << '\n';
+
+    // Exporting IDs: every variant keeps all the text
+    std::vector<std::uint64_t> ids(20'000'000);
+    for (auto& id : ids) {
+        id = gen() >> (gen() % 40);
+    }
+    bench("vector<string>, std::to_string  ", [&] {
+        std::vector<std::string> out;
+        out.reserve(ids.size());
+        std::size_t n = 0;
+        for (auto s : ids | std::views::transform([](auto id) { return std::to_string(id); })) {
+            n += s.size();
+            out.push_back(std::move(s));
+        }
+        return n;
+    });
+    bench("one string, views::to_chars     ", [&] {
+        std::string out;
+        for (auto s : ids | my::views::to_chars) {
+            out += s;
+            out += '\n';
+        }
+        return out.size() - ids.size();
+    });
+    bench("to_chars_table                  ", [&] {
+        my::ranges::to_chars_table table{ids};
+        return table.text().size() - table.size();
+    });
+    return ok ? 0 : 1;
+}
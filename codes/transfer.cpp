@@ -0,0 +1,392 @@
+#include "raii.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+/// Kernel-side copies. All of them use and advance the current file
+/// offsets, just like read/write, so they can be mixed and resumed.
+enum class transfer_method {
+    copy_file_range, // file to file, may share extents (reflink) on CoW filesystems
+    sendfile,        // mmap-able file to anything, notably sockets
+    splice,          // anything to anything, through a pipe
+    buffered,        // read/write loop, always works
+};
+
+namespace detail {
+
+// Errors that mean "this method does not apply to these descriptors"
+inline bool unsupported(int err) noexcept {
+    return err == EINVAL || err == EXDEV || err == ENOSYS ||
+           err == EOPNOTSUPP || err == EBADF || err == ESPIPE;
+}
+
+inline std::system_error error(const char* what) {
+    return {errno, std::system_category(), what};
+}
+
+/// Each step copies up to `count` bytes, and returns nullopt if the
+/// method cannot be used at all; it then must not have copied anything.
+inline std::optional<std::size_t> by_copy_file_range(int in, int out,
+                                                     std::size_t count) {
+    std::size_t done = 0;
+    while (done < count) {
+        auto n = ::copy_file_range(in, nullptr, out, nullptr, count - done, 0);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (done == 0 && unsupported(errno)) {
+                return std::nullopt;
+            }
+            throw error("copy_file_range");
+        }
+        if (n == 0) {
+            break; // EOF
+        }
+        done += std::size_t(n);
+    }
+    return done;
+}
+
+inline std::optional<std::size_t> by_sendfile(int in, int out,
+                                              std::size_t count) {
+    std::size_t done = 0;
+    while (done < count) {
+        auto n = ::sendfile(out, in, nullptr, std::min<std::size_t>(count - done, 1 << 30));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (done == 0 && unsupported(errno)) {
+                return std::nullopt;
+            }
+            throw error("sendfile");
+        }
+        if (n == 0) {
+            break;
+        }
+        done += std::size_t(n);
+    }
+    return done;
+}
+
+inline std::size_t by_buffered(int in, int out, std::size_t count);
+
+/// Unlike the others, this one can find out too late that `out` won't
+/// take a splice: the input is already in the pipe. It then writes the
+/// pipe out by read/write, and returns nullopt with `done` bytes copied.
+inline std::optional<std::size_t> by_splice(int in, int out, std::size_t count,
+                                            std::size_t& done) {
+    done = 0;
+    // Known in advance: splice refuses to append
+    if (int fl = ::fcntl(out, F_GETFL); fl < 0 || (fl & O_APPEND)) {
+        return std::nullopt;
+    }
+    int p[2];
+    if (::pipe2(p, O_CLOEXEC) != 0) {
+        return std::nullopt;
+    }
+    auto pipe_r = make_unique_fd(p[0]);
+    auto pipe_w = make_unique_fd(p[1]);
+
+    while (done < count) {
+        auto n = ::splice(in, nullptr, p[1], nullptr,
+                          std::min<std::size_t>(count - done, 1 << 20),
+                          SPLICE_F_MOVE | SPLICE_F_MORE);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (done == 0 && unsupported(errno)) {
+                return std::nullopt;
+            }
+            throw error("splice");
+        }
+        if (n == 0) {
+            break;
+        }
+        // Drain the pipe completely, so a failure can't strand bytes in it
+        for (auto left = n; left > 0;) {
+            auto m = ::splice(p[0], nullptr, out, nullptr, std::size_t(left),
+                              SPLICE_F_MOVE | SPLICE_F_MORE);
+            if (m < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (!unsupported(errno)) {
+                    throw error("splice");
+                }
+                done += std::size_t(n - left) + by_buffered(p[0], out, std::size_t(left));
+                return std::nullopt;
+            }
+            left -= m;
+        }
+        done += std::size_t(n);
+    }
+    return done;
+}
+
+inline std::size_t by_buffered(int in, int out, std::size_t count) {
+    constexpr std::size_t buf_size = 1 << 17;
+    auto buf = make_aligned_bytes(4096, buf_size);
+    std::size_t done = 0;
+    while (done < count) {
+        auto n = ::read(in, buf.get(), std::min(buf_size, count - done));
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw error("read");
+        }
+        if (n == 0) {
+            break;
+        }
+        for (ssize_t w = 0; w < n;) {
+            auto m = ::write(out, buf.get() + w, std::size_t(n - w));
+            if (m < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw error("write");
+            }
+            w += m;
+        }
+        done += std::size_t(n);
+    }
+    return done;
+}
+
+} // namespace detail
+
+struct transfer_result {
+    std::size_t bytes;
+    transfer_method method;
+};
+
+/// Copy up to `count` bytes (default: until EOF) from `in` to `out`,
+/// using the cheapest method the kernel accepts for this pair.
+inline transfer_result
+transfer(const unique_fd& in, const unique_fd& out,
+         std::size_t count = std::numeric_limits<std::size_t>::max()) {
+    int i = int(in.get()), o = int(out.get());
+    if (auto n = detail::by_copy_file_range(i, o, count)) {
+        return {*n, transfer_method::copy_file_range};
+    }
+    if (auto n = detail::by_sendfile(i, o, count)) {
+        return {*n, transfer_method::sendfile};
+    }
+    std::size_t spliced;
+    if (auto n = detail::by_splice(i, o, count, spliced)) {
+        return {*n, transfer_method::splice};
+    }
+    return {spliced + detail::by_buffered(i, o, count - spliced), transfer_method::buffered};
+}
+
+inline const char* to_string(transfer_method m) noexcept {
+    switch (m) {
+    case transfer_method::copy_file_range:
+        return "copy_file_range";
+    case transfer_method::sendfile:
+        return "sendfile";
+    case transfer_method::splice:
+        return "splice";
+    case transfer_method::buffered:
+        return "buffered";
+    }
+    return "?";
+}
+
+// From "Custom Iterator", for comparison
+
+class line_iterator {
+public:
+    using difference_type = int;
+    using value_type = std::string;
+    using pointer = value_type*;
+    using reference = value_type&;
+    using iterator_category = std::input_iterator_tag;
+
+    static struct sentinel_type {
+    } sentinel;
+
+private:
+    std::istream* is_;
+    value_type value_;
+
+    void next() {
+        std::getline(*is_, value_);
+    }
+
+    bool done() const {
+        return is_->eof();
+    }
+
+public:
+    line_iterator(std::istream& is) : is_(&is) {
+        this->next();
+    }
+
+    const value_type& operator*() const {
+        return value_;
+    }
+
+    line_iterator& operator++() {
+        this->next();
+        return *this;
+    }
+    line_iterator operator++(int) {
+        auto old = *this;
+        ++(*this);
+        return old;
+    }
+
+    bool operator==(sentinel_type) const {
+        return this->done();
+    }
+};
+
+class iter_line {
+private:
+    std::istream& is_;
+
+public:
+    iter_line(std::istream& is) : is_(is) {
+    }
+
+    auto begin() {
+        return line_iterator(is_);
+    }
+
+    auto end() {
+        return line_iterator::sentinel;
+    }
+};
+
+class ostream_iterator_2 {
+public:
+    using difference_type = int;
+    using iterator_category = std::output_iterator_tag;
+
+private:
+    std::ostream* os_;
+    std::string prefix_;
+    std::string postfix_;
+
+    template <class T>
+    void output(const T& x) {
+        (*os_) << prefix_ << x << postfix_;
+    }
+
+public:
+    ostream_iterator_2(std::ostream& os, std::string prefix, std::string postfix)
+        : os_(&os), prefix_(std::move(prefix)), postfix_(std::move(postfix)) {
+    }
+
+    ostream_iterator_2& operator*() {
+        return *this;
+    }
+    ostream_iterator_2& operator++() {
+        return *this;
+    }
+    ostream_iterator_2& operator++(int) {
+        return *this;
+    }
+
+    template <class T>
+    ostream_iterator_2& operator=(const T& x) {
+        output(x);
+        return *this;
+    }
+};
+
+template <class F>
+void bench(const char* name, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    auto what = f();
+    auto t1 = std::chrono::steady_clock::now();
+    std::cout << name << ": "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count()
+              << " ms" << what << '\n';
+}
+
+int main() {
+    const char* src = "transfer_src.txt";
+    const char* dst = "transfer_dst.txt";
+    {
+        file_ptr fp{std::fopen(src, "w")};
+        for (int i = 0; i < 4'000'000; ++i) {
+            std::fprintf(fp.get(), "line %d of the input file\n", i);
+        }
+    }
+
+    bench("iter_line + ostream_iterator_2", [&] {
+        std::ifstream ifs(src);
+        std::ofstream ofs(dst);
+        std::ranges::copy(iter_line(ifs), ostream_iterator_2(ofs, "", "\n"));
+        return "";
+    });
+    bench("read/write loop               ", [&] {
+        auto in = open_fd(src, O_RDONLY);
+        auto out = open_fd(dst, O_WRONLY | O_CREAT | O_TRUNC);
+        detail::by_buffered(int(in.get()), int(out.get()), std::size_t(-1));
+        return "";
+    });
+    bench("transfer                      ", [&] {
+        auto in = open_fd(src, O_RDONLY);
+        auto out = open_fd(dst, O_WRONLY | O_CREAT | O_TRUNC);
+        auto r = transfer(in, out);
+        return std::string(" (") + to_string(r.method) + ")";
+    });
+
+    // Appending: copy_file_range, sendfile and splice all refuse
+    bench("transfer, appending           ", [&] {
+        auto in = open_fd(src, O_RDONLY);
+        auto out = open_fd(dst, O_WRONLY | O_APPEND);
+        auto r = transfer(in, out);
+        struct stat a, b;
+        ::fstat(int(in.get()), &a);
+        ::fstat(int(out.get()), &b);
+        bool ok = r.bytes == std::size_t(a.st_size) && b.st_size == 2 * a.st_size;
+        return std::string(" (") + to_string(r.method) + ", " + (ok ? "appended" : "FAILED") +
+               ")";
+    });
+
+    // File to socket: copy_file_range refuses, sendfile takes over
+    int sv[2];
+    ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sv);
+    auto tx = make_unique_fd(sv[0]);
+    auto rx = make_unique_fd(sv[1]);
+    std::size_t received = 0;
+    std::jthread sink{[&] {
+        char buf[1 << 16];
+        for (ssize_t n; (n = ::read(int(rx.get()), buf, sizeof(buf))) > 0;) {
+            received += std::size_t(n);
+        }
+    }};
+    bench("transfer to socket            ", [&] {
+        auto in = open_fd(src, O_RDONLY);
+        auto r = transfer(in, tx);
+        tx.reset(); // EOF for the sink
+        return std::string(" (") + to_string(r.method) + ", " +
+               std::to_string(r.bytes) + " bytes)";
+    });
+    sink.join();
+    std::cout << received << " bytes received\n";
+
+    std::remove(src);
+    std::remove(dst);
+}
@@ -0,0 +1,284 @@
+#pragma GCC diagnostic ignored "-Wpsabi" // vectors passed between inlined helpers
+
+#include "wide_int.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <span>
+#include <utility>
+#include <vector>
+
+template <class T, std::size_t Bytes>
+using vec_t [[gnu::vector_size(Bytes)]] = T;
+
+// Compile-time checks: everything is constexpr
+static_assert(sizeof(uint256) == 32 && std::is_trivially_copyable_v<uint256>);
+static_assert((uint128(1) << 64) - 1 == uint128(~std::uint64_t{0}));
+static_assert(int128(-7) / 2 == -3 && int128(-7) % 2 == -1);
+static_assert(int256(-1) >> 200 == -1 && (uint256(1) << 255 >> 255) == 1);
+static_assert(std::numeric_limits<int128>::max() + 1 == std::numeric_limits<int128>::min());
+static_assert(std::numeric_limits<uint256>::digits10 == 77);
+static_assert(std::numeric_limits<uint128>::has_denorm == std::denorm_absent &&
+              !std::numeric_limits<uint128>::has_denorm_loss);
+static_assert(uint256(~std::uint64_t{0}) * ~std::uint64_t{0} ==
+              (uint256(1) << 128) - (uint256(1) << 65) + 1);
+static_assert(int256(-3) < int256(2) && uint256(3) > uint256(2));
+static_assert(int128(-5) * int128(-5) == 25);
+static_assert(uint256(10).limbs()[0] == 10 && int256(-1).limbs()[3] == ~std::uint64_t{0});
+static_assert([] {
+    // 30! needs 108 bits
+    uint128 f = 1;
+    for (int i = 2; i <= 30; ++i) {
+        f *= i;
+    }
+    char buf[64];
+    auto end = to_chars(buf, buf + 64, f).ptr;
+    return std::string_view(buf, std::size_t(end - buf)) == "265252859812191058636308480000000";
+}());
+
+namespace detail {
+
+/// 0 where lane k starts an element (every N limbs), else lane k - 1's
+/// value: each carry moves up one limb, within its element
+template <std::size_t N, class V, std::size_t... I>
+[[gnu::always_inline]] inline V carry_up(V c, std::index_sequence<I...>) noexcept {
+    using M = vec_t<std::int64_t, sizeof(V)>;
+    constexpr M from{(I % N == 0 ? std::int64_t(I) : std::int64_t(I) - 1)...};
+    constexpr V keep{(I % N == 0 ? 0 : ~std::uint64_t{0})...};
+    return __builtin_shuffle(c, from) & keep;
+}
+
+/// out = a + b for the elements in one register of limbs: the limbs add
+/// in parallel, and then the carries ripple, at most N - 1 steps. A limb
+/// carries out at most once (x + y + 1 <= 2^65 - 1), so each step only
+/// needs the carries the last one made.
+template <std::size_t N, std::size_t Bytes>
+[[gnu::always_inline]] inline void add_block(const std::uint64_t* a, const std::uint64_t* b,
+                                             std::uint64_t* out) noexcept {
+    using V = vec_t<std::uint64_t, Bytes>;
+    constexpr auto lanes = std::make_index_sequence<Bytes / 8>{};
+    V x, y;
+    std::memcpy(&x, a, sizeof(V));
+    std::memcpy(&y, b, sizeof(V));
+    V s = x + y;
+    V carry = V(s < x) & 1;
+    for (std::size_t step = 1; step < N; ++step) {
+        V t = s + carry_up<N>(carry, lanes);
+        carry = V(t < s) & 1;
+        s = t;
+    }
+    std::memcpy(out, &s, sizeof(V));
+}
+
+template <std::size_t Bits, bool Signed, std::size_t Bytes>
+[[gnu::always_inline]] inline void add_kernel(const wide_int<Bits, Signed>* a,
+                                              const wide_int<Bits, Signed>* b,
+                                              wide_int<Bits, Signed>* out, std::size_t n) {
+    constexpr std::size_t N = Bits / 64;
+    std::size_t i = 0;
+    if constexpr (Bytes > 0 && Bytes / 8 % N == 0) {
+        constexpr std::size_t per = Bytes / 8 / N; // elements per register
+        // An array of wide_int is an array of limbs
+        for (; i + per <= n; i += per) {
+            add_block<N, Bytes>(reinterpret_cast<const std::uint64_t*>(a + i),
+                                reinterpret_cast<const std::uint64_t*>(b + i),
+                                reinterpret_cast<std::uint64_t*>(out + i));
+        }
+    }
+    for (; i < n; ++i) {
+        out[i] = a[i] + b[i];
+    }
+}
+
+template <std::size_t Bits, bool Signed>
+void add_scalar(const wide_int<Bits, Signed>* a, const wide_int<Bits, Signed>* b,
+                wide_int<Bits, Signed>* out, std::size_t n) {
+    add_kernel<Bits, Signed, 0>(a, b, out, n);
+}
+
+template <std::size_t Bits, bool Signed>
+[[gnu::target("avx2")]] void add_avx2(const wide_int<Bits, Signed>* a,
+                                      const wide_int<Bits, Signed>* b,
+                                      wide_int<Bits, Signed>* out, std::size_t n) {
+    add_kernel<Bits, Signed, 32>(a, b, out, n);
+}
+
+template <std::size_t Bits, bool Signed>
+[[gnu::target("avx512f")]] void add_avx512(const wide_int<Bits, Signed>* a,
+                                           const wide_int<Bits, Signed>* b,
+                                           wide_int<Bits, Signed>* out, std::size_t n) {
+    add_kernel<Bits, Signed, 64>(a, b, out, n);
+}
+
+} // namespace detail
+
+// Batch versions: element by element, the same results as the operators.
+// `out` may be `a` or `b`.
+
+/// Vectorized where the limbs fill whole registers (128 and 256 bits)
+template <std::size_t Bits, bool Signed>
+void add(std::span<const wide_int<Bits, Signed>> a, std::span<const wide_int<Bits, Signed>> b,
+         std::span<wide_int<Bits, Signed>> out) {
+    std::size_t n = std::min({a.size(), b.size(), out.size()});
+    static const auto fn = __builtin_cpu_supports("avx512f") ? &detail::add_avx512<Bits, Signed>
+                           : __builtin_cpu_supports("avx2")  ? &detail::add_avx2<Bits, Signed>
+                                                             : &detail::add_scalar<Bits, Signed>;
+    fn(a.data(), b.data(), out.data(), n);
+}
+
+/// Scalar: AVX2 multiplies 32x32 -> 64 at most, and AVX-512 IFMA 52 bits,
+/// so a vector of 64x64 -> 128 products costs more than mulx does
+template <std::size_t Bits, bool Signed>
+void mul(std::span<const wide_int<Bits, Signed>> a, std::span<const wide_int<Bits, Signed>> b,
+         std::span<wide_int<Bits, Signed>> out) {
+    std::size_t n = std::min({a.size(), b.size(), out.size()});
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = a[i] * b[i];
+    }
+}
+
+template <class F>
+void bench(const char* name, F f) {
+    auto t0 = std::chrono::steady_clock::now();
+    f();
+    auto t1 = std::chrono::steady_clock::now();
+    println("{}: {:.1f} ms", name, std::chrono::duration<double, std::milli>(t1 - t0).count());
+}
+
+int main() {
+    bool ok = true;
+    auto check = [&](bool c, std::string_view what) {
+        if (!c) {
+            println("FAILED: {}", what);
+            ok = false;
+        }
+    };
+
+    // Against unsigned __int128 and __int128, on random values and edges
+    std::mt19937_64 rng(1);
+    using u128 = unsigned __int128;
+    auto random128 = [&] {
+        u128 x = u128(rng()) << 64 | rng();
+        switch (rng() % 4) {
+        case 0: return x >> (rng() % 128);
+        case 1: return ~u128(0) - (rng() % 4);
+        default: return x;
+        }
+    };
+    for (int i = 0; i < 200000; ++i) {
+        u128 x = random128(), y = random128() | 1;
+        uint128 a = x, b = y;
+        check(u128(a + b) == x + y && u128(a - b) == x - y && u128(a * b) == x * y,
+              "u128 + - *");
+        check(u128(a / b) == x / y && u128(a % b) == x % y, "u128 / %");
+        check((a < b) == (x < y) && u128(a >> int(i % 128)) == x >> (i % 128) &&
+                  u128(a << int(i % 128)) == x << (i % 128),
+              "u128 compare, shifts");
+        __int128 sx = __int128(x), sy = __int128(y);
+        int128 c = sx, d = sy;
+        if (sy != -1) {
+            check(__int128(c / d) == sx / sy && __int128(c % d) == sx % sy, "i128 / %");
+        }
+        check((c < d) == (sx < sy) && __int128(c >> int(i % 128)) == sx >> (i % 128),
+              "i128 compare, shift");
+    }
+    // 256 bits: a 128 x 128 product fits; divide it back
+    for (int i = 0; i < 20000; ++i) {
+        uint256 a = uint128(random128()), b = uint128(random128() | 1);
+        check(a * b / b == a && a * b % b == 0 && (a * b + 1) % b == (b == 1 ? 0 : 1),
+              "u256 * /");
+        int256 s = -int256(a >> 1) - 1; // |s * b| < 2^255
+        check(s * int256(b) / int256(b) == s && (s >> 255) == -1, "i256");
+    }
+
+    check(fmt_lib::format("{}", std::numeric_limits<uint256>::max()) ==
+              "115792089237316195423570985008687907853269984665640564039457584007913129639935",
+          "uint256 max");
+    check(fmt_lib::format("{}", std::numeric_limits<int128>::min()) ==
+              "-170141183460469231731687303715884105728",
+          "int128 min");
+    check(fmt_lib::format("{:x}", uint256(1) << 200) == "1" + std::string(50, '0'), "hex");
+    check(fmt_lib::format("{:>8X}|{:<6b}|{:o}", uint128(0xbeef), int128(-5), int256(8)) ==
+              "    BEEF|-101  |10",
+          "specs");
+    check(fmt_lib::format("{}", int256(0)) == "0", "zero");
+    check(fmt_lib::format("{:032x}", uint128(0xbeef)) == std::string(28, '0') + "beef",
+          "zero-padded hex");
+    check(fmt_lib::format("{:+}|{:+}|{: }", int128(7), int256(-7), uint128(7)) == "+7|-7| 7",
+          "sign");
+    check(fmt_lib::format("{:#x}|{:#X}|{:#b}|{:#o}|{:#o}", uint128(255), uint256(255), int128(-2),
+                          uint128(8), uint128(0)) == "0xff|0XFF|-0b10|010|0",
+          "alternate form");
+    check(fmt_lib::format("{:+#010x}|{:*^7}", int128(-255), uint128(42)) == "-0x00000ff|**42***",
+          "sign, prefix, zero padding, center");
+    auto rejects = [](std::string_view spec, const auto& x) {
+        try {
+            (void)fmt_lib::vformat(spec, fmt_lib::make_format_args(x));
+        } catch (const fmt_lib::format_error&) {
+            return true;
+        }
+        return false;
+    };
+    check(rejects("{:.3}", uint128(123456)) && rejects("{:.3}", int256(-1)), "precision");
+
+    // Batch add, every kernel, against the operator
+    constexpr std::size_t n = 1 << 20;
+    std::vector<uint256> a(n), b(n), sum(n), expect(n);
+    std::vector<uint128> a2(n), b2(n), sum2(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        // Many all-ones limbs, so carries ripple all the way
+        auto limb = [&] { return rng() % 3 == 0 ? ~std::uint64_t{0} : rng(); };
+        a[i] = uint256::from_limbs({limb(), limb(), limb(), limb()});
+        b[i] = uint256::from_limbs({limb(), limb(), limb(), limb()});
+        a2[i] = uint128(a[i]);
+        b2[i] = uint128(b[i]);
+        expect[i] = a[i] + b[i];
+    }
+    detail::add_scalar(a.data(), b.data(), sum.data(), n);
+    check(sum == expect, "add, scalar");
+    if (__builtin_cpu_supports("avx2")) {
+        detail::add_avx2(a.data(), b.data(), sum.data(), n);
+        check(sum == expect, "add, avx2");
+        detail::add_avx2(a2.data(), b2.data(), sum2.data(), n);
+        check(std::ranges::equal(sum2, expect, {}, {}, [](auto& x) { return uint128(x); }),
+              "add 128, avx2");
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        detail::add_avx512(a.data(), b.data(), sum.data(), n);
+        check(sum == expect, "add, avx512");
+        detail::add_avx512(a2.data(), b2.data(), sum2.data(), n);
+        check(std::ranges::equal(sum2, expect, {}, {}, [](auto& x) { return uint128(x); }),
+              "add 128, avx512");
+    }
+
+    // Every buffer was written when it was made, so no page faults land
+    // in the timings, and one pass of each is enough
+    bench("uint256 add, scalar loop ", [&] {
+        for (int r = 0; r < 20; ++r) {
+            detail::add_scalar(a.data(), b.data(), sum.data(), n);
+        }
+    });
+    bench("uint256 add, batch       ", [&] {
+        for (int r = 0; r < 20; ++r) {
+            add<256, false>(a, b, sum);
+        }
+    });
+    bench("uint128 add, scalar loop ", [&] {
+        for (int r = 0; r < 20; ++r) {
+            detail::add_scalar(a2.data(), b2.data(), sum2.data(), n);
+        }
+    });
+    bench("uint128 add, batch       ", [&] {
+        for (int r = 0; r < 20; ++r) {
+            add<128, false>(a2, b2, sum2);
+        }
+    });
+    bench("uint256 mul, batch       ", [&] {
+        for (int r = 0; r < 20; ++r) {
+            mul<256, false>(a, b, sum);
+        }
+    });
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,575 @@
+#pragma once
+
+// Fixed-width integers past 64 bits, picking up where "Arithmetic Types
+// in C++" stops:
+//
+//   uint256 h = 0;
+//   h = h * prime + x;                      // wraps, like unsigned
+//   constexpr auto big = int128(1) << 100;  // everything is constexpr
+//   print("{:064x}\n", h);                  // zero-padded hex, as for int
+//
+// Two's complement in Bits / 64 limbs, least significant first, nothing
+// else: trivially copyable, and an array of them is an array of limbs.
+// Unlike int, signed arithmetic wraps too: overflow is not undefined.
+// Division truncates toward zero; dividing by zero, or shifting by Bits
+// or more, is undefined, as for the built-in types.
+//
+// At run time, + and - are carry chains (_addcarry_u64, _subborrow_u64 on
+// x86-64), and * is schoolbook on 64x64->128 products (unsigned __int128).
+// In constant evaluation the same loops run on unsigned __int128 alone.
+
+#include "print.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace wide_detail {
+
+using limb = std::uint64_t;
+using u128 = unsigned __int128;
+
+constexpr limb addc(limb a, limb b, unsigned char& carry) noexcept {
+#if defined(__x86_64__)
+    if (!std::is_constant_evaluated()) {
+        unsigned long long r;
+        carry = _addcarry_u64(carry, a, b, &r);
+        return r;
+    }
+#endif
+    u128 s = u128(a) + b + carry;
+    carry = static_cast<unsigned char>(s >> 64);
+    return limb(s);
+}
+
+constexpr limb subb(limb a, limb b, unsigned char& borrow) noexcept {
+#if defined(__x86_64__)
+    if (!std::is_constant_evaluated()) {
+        unsigned long long r;
+        borrow = _subborrow_u64(borrow, a, b, &r);
+        return r;
+    }
+#endif
+    u128 d = u128(a) - b - borrow;
+    borrow = static_cast<unsigned char>((d >> 64) != 0);
+    return limb(d);
+}
+
+} // namespace wide_detail
+
+template <std::size_t Bits, bool Signed>
+class wide_int {
+    static_assert(Bits % 64 == 0 && Bits >= 128, "a multiple of 64 bits, 128 or more");
+
+public:
+    static constexpr std::size_t limb_count = Bits / 64;
+    using limbs_type = std::array<std::uint64_t, limb_count>;
+
+    constexpr wide_int() noexcept = default;
+
+    /// Sign-extends signed arguments, as the built-in conversions do
+    template <std::integral T>
+    constexpr wide_int(T x) noexcept {
+        v_[0] = std::uint64_t(x);
+        std::uint64_t fill = std::is_signed_v<T> && x < 0 ? ~std::uint64_t{0} : 0;
+        for (std::size_t i = 1; i < limb_count; ++i) {
+            v_[i] = fill;
+        }
+    }
+
+    constexpr wide_int(__int128 x) noexcept : wide_int(std::int64_t(x >> 64)) {
+        v_[1] = std::uint64_t(x >> 64);
+        v_[0] = std::uint64_t(x);
+    }
+    constexpr wide_int(unsigned __int128 x) noexcept : wide_int(0) {
+        v_[1] = std::uint64_t(x >> 64);
+        v_[0] = std::uint64_t(x);
+    }
+
+    /// From another width or signedness; explicit when narrowing
+    template <std::size_t B, bool S>
+    explicit(B > Bits) constexpr wide_int(const wide_int<B, S>& x) noexcept {
+        auto& src = x.limbs();
+        std::uint64_t fill = x.negative() ? ~std::uint64_t{0} : 0;
+        for (std::size_t i = 0; i < limb_count; ++i) {
+            v_[i] = i < src.size() ? src[i] : fill;
+        }
+    }
+
+    static constexpr wide_int from_limbs(const limbs_type& v) noexcept {
+        wide_int r;
+        r.v_ = v;
+        return r;
+    }
+    constexpr const limbs_type& limbs() const noexcept {
+        return v_;
+    }
+
+    /// Truncates, as the built-in narrowing conversions do
+    template <std::integral T>
+    explicit constexpr operator T() const noexcept {
+        if constexpr (std::is_same_v<T, bool>) {
+            return *this != 0;
+        } else {
+            return T(v_[0]);
+        }
+    }
+    explicit constexpr operator unsigned __int128() const noexcept {
+        return wide_detail::u128(v_[1]) << 64 | v_[0];
+    }
+    explicit constexpr operator __int128() const noexcept {
+        return __int128(static_cast<unsigned __int128>(*this));
+    }
+
+    constexpr bool negative() const noexcept {
+        return Signed && (v_[limb_count - 1] >> 63) != 0;
+    }
+
+    // Arithmetic, modulo 2^Bits
+
+    friend constexpr wide_int operator+(const wide_int& a, const wide_int& b) noexcept {
+        wide_int r;
+        unsigned char c = 0;
+        for (std::size_t i = 0; i < limb_count; ++i) {
+            r.v_[i] = wide_detail::addc(a.v_[i], b.v_[i], c);
+        }
+        return r;
+    }
+
+    friend constexpr wide_int operator-(const wide_int& a, const wide_int& b) noexcept {
+        wide_int r;
+        unsigned char c = 0;
+        for (std::size_t i = 0; i < limb_count; ++i) {
+            r.v_[i] = wide_detail::subb(a.v_[i], b.v_[i], c);
+        }
+        return r;
+    }
+
+    /// Schoolbook, skipping the products that only reach past Bits
+    friend constexpr wide_int operator*(const wide_int& a, const wide_int& b) noexcept {
+        wide_int r;
+        for (std::size_t i = 0; i < limb_count; ++i) {
+            std::uint64_t carry = 0;
+            for (std::size_t j = 0; i + j < limb_count; ++j) {
+                wide_detail::u128 t =
+                    wide_detail::u128(a.v_[i]) * b.v_[j] + r.v_[i + j] + carry;
+                r.v_[i + j] = std::uint64_t(t);
+                carry = std::uint64_t(t >> 64);
+            }
+        }
+        return r;
+    }
+
+    friend constexpr wide_int operator/(const wide_int& a, const wide_int& b) noexcept {
+        return divmod(a, b).first;
+    }
+    friend constexpr wide_int operator%(const wide_int& a, const wide_int& b) noexcept {
+        return divmod(a, b).second;
+    }
+
+    constexpr wide_int operator-() const noexcept {
+        return wide_int(0) - *this;
+    }
+    constexpr wide_int operator+() const noexcept {
+        return *this;
+    }
+    constexpr wide_int operator~() const noexcept {
+        wide_int r;
+        for (std::size_t i = 0; i < limb_count; ++i) {
+            r.v_[i] = ~v_[i];
+        }
+        return r;
+    }
+
+    friend constexpr wide_int operator&(const wide_int& a, const wide_int& b) noexcept {
+        return bitwise(a, b, [](std::uint64_t x, std::uint64_t y) { return x & y; });
+    }
+    friend constexpr wide_int operator|(const wide_int& a, const wide_int& b) noexcept {
+        return bitwise(a, b, [](std::uint64_t x, std::uint64_t y) { return x | y; });
+    }
+    friend constexpr wide_int operator^(const wide_int& a, const wide_int& b) noexcept {
+        return bitwise(a, b, [](std::uint64_t x, std::uint64_t y) { return x ^ y; });
+    }
+
+    /// 0 <= n < Bits
+    friend constexpr wide_int operator<<(const wide_int& a, int n) noexcept {
+        wide_int r;
+        std::size_t limbs = std::size_t(n) / 64;
+        unsigned bits = unsigned(n) % 64;
+        for (std::size_t i = limb_count; i-- > limbs;) {
+            std::size_t j = i - limbs;
+            r.v_[i] = a.v_[j] << bits;
+            if (bits != 0 && j > 0) {
+                r.v_[i] |= a.v_[j - 1] >> (64 - bits);
+            }
+        }
+        return r;
+    }
+
+    /// 0 <= n < Bits; arithmetic (sign-filling) when Signed
+    friend constexpr wide_int operator>>(const wide_int& a, int n) noexcept {
+        std::uint64_t fill = a.negative() ? ~std::uint64_t{0} : 0;
+        wide_int r;
+        std::size_t limbs = std::size_t(n) / 64;
+        unsigned bits = unsigned(n) % 64;
+        for (std::size_t i = 0; i < limb_count; ++i) {
+            std::size_t j = i + limbs;
+            std::uint64_t lo = j < limb_count ? a.v_[j] : fill;
+            std::uint64_t hi = j + 1 < limb_count ? a.v_[j + 1] : fill;
+            r.v_[i] = bits == 0 ? lo : lo >> bits | hi << (64 - bits);
+        }
+        return r;
+    }
+
+    constexpr wide_int& operator+=(const wide_int& b) noexcept {
+        return *this = *this + b;
+    }
+    constexpr wide_int& operator-=(const wide_int& b) noexcept {
+        return *this = *this - b;
+    }
+    constexpr wide_int& operator*=(const wide_int& b) noexcept {
+        return *this = *this * b;
+    }
+    constexpr wide_int& operator/=(const wide_int& b) noexcept {
+        return *this = *this / b;
+    }
+    constexpr wide_int& operator%=(const wide_int& b) noexcept {
+        return *this = *this % b;
+    }
+    constexpr wide_int& operator&=(const wide_int& b) noexcept {
+        return *this = *this & b;
+    }
+    constexpr wide_int& operator|=(const wide_int& b) noexcept {
+        return *this = *this | b;
+    }
+    constexpr wide_int& operator^=(const wide_int& b) noexcept {
+        return *this = *this ^ b;
+    }
+    constexpr wide_int& operator<<=(int n) noexcept {
+        return *this = *this << n;
+    }
+    constexpr wide_int& operator>>=(int n) noexcept {
+        return *this = *this >> n;
+    }
+    constexpr wide_int& operator++() noexcept {
+        return *this += 1;
+    }
+    constexpr wide_int& operator--() noexcept {
+        return *this -= 1;
+    }
+    constexpr wide_int operator++(int) noexcept {
+        wide_int old = *this;
+        ++*this;
+        return old;
+    }
+    constexpr wide_int operator--(int) noexcept {
+        wide_int old = *this;
+        --*this;
+        return old;
+    }
+
+    friend constexpr bool operator==(const wide_int&, const wide_int&) noexcept = default;
+
+    friend constexpr std::strong_ordering operator<=>(const wide_int& a,
+                                                      const wide_int& b) noexcept {
+        if (a.negative() != b.negative()) {
+            return a.negative() ? std::strong_ordering::less : std::strong_ordering::greater;
+        }
+        // Same sign: two's complement orders like unsigned
+        for (std::size_t i = limb_count; i-- > 0;) {
+            if (a.v_[i] != b.v_[i]) {
+                return a.v_[i] <=> b.v_[i];
+            }
+        }
+        return std::strong_ordering::equal;
+    }
+
+    /// Quotient (toward zero) and remainder (the sign of `a`)
+    static constexpr std::pair<wide_int, wide_int> divmod(const wide_int& a,
+                                                          const wide_int& b) noexcept {
+        using U = wide_int<Bits, false>;
+        bool qneg = a.negative() != b.negative();
+        auto [q, r] = udivmod(U(a.negative() ? -a : a), U(b.negative() ? -b : b));
+        return {qneg ? -wide_int(q) : wide_int(q), a.negative() ? -wide_int(r) : wide_int(r)};
+    }
+
+private:
+    template <std::size_t, bool>
+    friend class wide_int;
+
+    template <class F>
+    static constexpr wide_int bitwise(const wide_int& a, const wide_int& b, F f) noexcept {
+        wide_int r;
+        for (std::size_t i = 0; i < limb_count; ++i) {
+            r.v_[i] = f(a.v_[i], b.v_[i]);
+        }
+        return r;
+    }
+
+    /// Unsigned; by one limb when the divisor fits in one (to_chars
+    /// divides by 10^19), otherwise shift and subtract, a bit at a time
+    static constexpr std::pair<wide_int<Bits, false>, wide_int<Bits, false>>
+    udivmod(const wide_int<Bits, false>& a, const wide_int<Bits, false>& b) noexcept {
+        using U = wide_int<Bits, false>;
+        U q, r;
+        if (b <= U(std::numeric_limits<std::uint64_t>::max())) {
+            std::uint64_t d = b.v_[0], rem = 0;
+            for (std::size_t i = limb_count; i-- > 0;) {
+                wide_detail::u128 cur = wide_detail::u128(rem) << 64 | a.v_[i];
+                q.v_[i] = std::uint64_t(cur / d);
+                rem = std::uint64_t(cur % d);
+            }
+            r.v_[0] = rem;
+            return {q, r};
+        }
+        int top = int(Bits) - 1;
+        while (top >= 0 && ((a.v_[std::size_t(top) / 64] >> (top % 64)) & 1) == 0) {
+            --top;
+        }
+        for (int i = top; i >= 0; --i) {
+            r = r << 1;
+            r.v_[0] |= (a.v_[std::size_t(i) / 64] >> (i % 64)) & 1;
+            if (r >= b) {
+                r -= b;
+                q.v_[std::size_t(i) / 64] |= std::uint64_t{1} << (i % 64);
+            }
+        }
+        return {q, r};
+    }
+
+    limbs_type v_{};
+};
+
+using int128 = wide_int<128, true>;
+using uint128 = wide_int<128, false>;
+using int256 = wide_int<256, true>;
+using uint256 = wide_int<256, false>;
+
+template <std::size_t Bits, bool Signed>
+struct std::numeric_limits<wide_int<Bits, Signed>> {
+    using T = wide_int<Bits, Signed>;
+
+    static constexpr bool is_specialized = true;
+    static constexpr bool is_signed = Signed;
+    static constexpr bool is_integer = true;
+    static constexpr bool is_exact = true;
+    static constexpr bool has_infinity = false;
+    static constexpr bool has_quiet_NaN = false;
+    static constexpr bool has_signaling_NaN = false;
+    static constexpr float_denorm_style has_denorm = denorm_absent;
+    static constexpr bool has_denorm_loss = false;
+    static constexpr float_round_style round_style = round_toward_zero;
+    static constexpr bool is_iec559 = false;
+    static constexpr bool is_bounded = true;
+    static constexpr bool is_modulo = true; // both signednesses wrap
+    static constexpr int digits = int(Bits) - Signed;
+    static constexpr int digits10 = int(digits * 30103LL / 100000); // log10(2)
+    static constexpr int max_digits10 = 0;
+    static constexpr int radix = 2;
+    static constexpr int min_exponent = 0;
+    static constexpr int min_exponent10 = 0;
+    static constexpr int max_exponent = 0;
+    static constexpr int max_exponent10 = 0;
+    static constexpr bool traps = false;
+    static constexpr bool tinyness_before = false;
+
+    static constexpr T min() noexcept {
+        return Signed ? T(1) << (int(Bits) - 1) : T(0);
+    }
+    static constexpr T lowest() noexcept {
+        return min();
+    }
+    static constexpr T max() noexcept {
+        return Signed ? ~min() : ~T(0);
+    }
+    static constexpr T epsilon() noexcept {
+        return 0;
+    }
+    static constexpr T round_error() noexcept {
+        return 0;
+    }
+    static constexpr T infinity() noexcept {
+        return 0;
+    }
+    static constexpr T quiet_NaN() noexcept {
+        return 0;
+    }
+    static constexpr T signaling_NaN() noexcept {
+        return 0;
+    }
+    static constexpr T denorm_min() noexcept {
+        return 0;
+    }
+};
+
+namespace wide_detail {
+
+/// The largest power of `base` in a limb, and its exponent
+constexpr std::pair<std::uint64_t, int> chunk_of(int base) noexcept {
+    std::uint64_t p = 1;
+    int n = 0;
+    while (p <= std::numeric_limits<std::uint64_t>::max() / std::uint64_t(base)) {
+        p *= std::uint64_t(base);
+        ++n;
+    }
+    return {p, n};
+}
+
+} // namespace wide_detail
+
+/// Like std::to_chars for the built-in types: bases 2 to 36, a '-' for
+/// negative values, no prefix. Digits are made a limb's worth at a time.
+template <std::size_t Bits, bool Signed>
+constexpr std::to_chars_result to_chars(char* first, char* last,
+                                        const wide_int<Bits, Signed>& x, int base = 10) {
+    using U = wide_int<Bits, false>;
+    U mag(x.negative() ? -x : x);
+    auto [chunk, chunk_digits] = wide_detail::chunk_of(base);
+
+    // Backwards into a buffer long enough for base 2
+    char buf[Bits];
+    char* p = buf + Bits;
+    do {
+        auto [q, r] = U::divmod(mag, U(chunk));
+        auto digits = std::uint64_t(r);
+        bool more = q != 0;
+        for (int i = 0; i < chunk_digits && (more || digits != 0); ++i) {
+            auto d = unsigned(digits % unsigned(base));
+            *--p = char(d < 10 ? '0' + d : 'a' + d - 10);
+            digits /= unsigned(base);
+        }
+        mag = q;
+    } while (mag != 0);
+    if (p == buf + Bits) {
+        *--p = '0';
+    }
+
+    std::size_t n = std::size_t(buf + Bits - p) + x.negative();
+    if (std::size_t(last - first) < n) {
+        return {last, std::errc::value_too_large};
+    }
+    if (x.negative()) {
+        *first++ = '-';
+    }
+    for (; p != buf + Bits; ++p) {
+        *first++ = *p;
+    }
+    return {first, std::errc{}};
+}
+
+/// Presentation types d, x, X, o, b; fill, align, sign, '#', '0' and
+/// width as for the built-in integers, and like them no precision. The
+/// width must be a number, not a nested replacement field.
+template <std::size_t Bits, bool Signed>
+struct fmt_lib::formatter<wide_int<Bits, Signed>, char> {
+    constexpr auto parse(auto& ctx) {
+        auto it = ctx.begin(), end = ctx.end();
+        auto is_align = [](char c) { return c == '<' || c == '>' || c == '^'; };
+        if (it != end && it + 1 != end && is_align(it[1]) && *it != '{' && *it != '}') {
+            fill_ = *it;
+            align_ = it[1];
+            it += 2;
+        } else if (it != end && is_align(*it)) {
+            align_ = *it++;
+        }
+        if (it != end && (*it == '+' || *it == '-' || *it == ' ')) {
+            sign_ = *it++;
+        }
+        if (it != end && *it == '#') {
+            alt_ = true;
+            ++it;
+        }
+        if (it != end && *it == '0') {
+            zero_ = true;
+            ++it;
+        }
+        for (; it != end && '0' <= *it && *it <= '9'; ++it) {
+            if (width_ > 100000) {
+                throw fmt_lib::format_error("width too large for wide_int");
+            }
+            width_ = width_ * 10 + std::size_t(*it - '0');
+        }
+        if (it != end && *it == '.') {
+            throw fmt_lib::format_error("precision not allowed for wide_int");
+        }
+        if (it != end && *it == '{') {
+            throw fmt_lib::format_error("dynamic width not supported for wide_int");
+        }
+        if (it != end && *it != '}') {
+            switch (*it++) {
+            case 'd': base_ = 10; break;
+            case 'x': base_ = 16; break;
+            case 'X': base_ = 16, upper_ = true; break;
+            case 'o': base_ = 8; break;
+            case 'b': base_ = 2; break;
+            default: throw fmt_lib::format_error("invalid type for wide_int");
+            }
+        }
+        if (it != end && *it != '}') {
+            throw fmt_lib::format_error("invalid format spec for wide_int");
+        }
+        return it;
+    }
+
+    auto format(const wide_int<Bits, Signed>& x, auto& ctx) const {
+        // Sign and prefix, then digits: '0' pads between the two
+        char buf[Bits + 3];
+        char* p = buf;
+        if (x.negative()) {
+            *p++ = '-';
+        } else if (sign_ == '+' || sign_ == ' ') {
+            *p++ = sign_;
+        }
+        wide_int<Bits, false> mag(x.negative() ? -x : x);
+        if (alt_ && base_ != 10 && (base_ != 8 || mag != 0)) {
+            *p++ = '0';
+            if (base_ != 8) {
+                *p++ = base_ == 2 ? 'b' : upper_ ? 'X' : 'x';
+            }
+        }
+        char* digits = p;
+        char* last = ::to_chars(digits, buf + sizeof(buf), mag, base_).ptr;
+        if (upper_) {
+            for (char* q = digits; q != last; ++q) {
+                *q = *q >= 'a' ? char(*q - 'a' + 'A') : *q;
+            }
+        }
+
+        auto n = std::size_t(last - buf);
+        std::size_t pad = width_ > n ? width_ - n : 0;
+        auto out = ctx.out();
+        if (zero_ && align_ == 0) {
+            out = std::copy(buf, digits, out);
+            out = std::fill_n(out, pad, '0');
+            return std::copy(digits, last, out);
+        }
+        std::size_t before = align_ == '<' ? 0 : align_ == '^' ? pad / 2 : pad;
+        out = std::fill_n(out, before, fill_);
+        out = std::copy(buf, last, out);
+        return std::fill_n(out, pad - before, fill_);
+    }
+
+private:
+    std::size_t width_ = 0;
+    int base_ = 10;
+    char fill_ = ' ';
+    char align_ = 0; // 0: right, with '0' padding after the sign if asked
+    char sign_ = '-';
+    bool alt_ = false;
+    bool zero_ = false;
+    bool upper_ = false;
+};